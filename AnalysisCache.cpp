@@ -0,0 +1,203 @@
+#include "AnalysisCache.h"
+#include "utils.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+const char kCacheMagic[4] = { 'W', 'M', 'A', 'C' };
+const uint32_t kCacheVersion = 2;
+
+// ļͷ (Ӳоֺо)
+struct CacheFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    int32_t width;
+    int32_t height;
+    int32_t regionCount;
+    int32_t watermarkLength;
+};
+
+// ͷ֮ݳ (ֽ)
+uint64_t payloadBytes(int regionCount, int watermarkLength) {
+    uint64_t hardWords = (static_cast<uint64_t>(watermarkLength) + 63) / 64;
+    return static_cast<uint64_t>(regionCount) * (hardWords * sizeof(uint64_t) + static_cast<uint64_t>(watermarkLength) * sizeof(double));
+}
+
+const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+
+inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// 64 λս (splitmix64)
+inline uint64_t finalizeHash(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+template <typename T>
+bool readArray(std::ifstream& in, T* data, size_t count) {
+    in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+    return static_cast<size_t>(in.gcount()) == count * sizeof(T);
+}
+
+template <typename T>
+void writeArray(std::ofstream& out, const T* data, size_t count) {
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+} // namespace
+
+AnalysisCache::AnalysisCache(const std::string& directory) : cacheDirectory(directory) {
+    if (!cacheDirectory.empty()) {
+        std::filesystem::create_directories(cacheDirectory);
+    }
+}
+
+uint64_t AnalysisCache::combine(uint64_t seed, uint64_t value) {
+    return finalizeHash(seed ^ (value * kPrime1 + kPrime2 + rotl64(seed, 17)));
+}
+
+// ÿа 8 ֽһ˷-תϣβ 8 ֽڲ
+uint64_t AnalysisCache::hashImage(const cv::Mat& image, uint64_t seed) {
+    if (image.empty() || image.type() != CV_8UC1) {
+        throw std::invalid_argument("AnalysisCache: image must be a non-empty CV_8UC1 matrix.");
+    }
+    uint64_t h = combine(seed, (static_cast<uint64_t>(image.rows) << 32) | static_cast<uint32_t>(image.cols));
+    const int cols = image.cols;
+    for (int y = 0; y < image.rows; ++y) {
+        const uchar* row = image.ptr<uchar>(y);
+        int x = 0;
+        for (; x + 8 <= cols; x += 8) {
+            uint64_t word;
+            std::memcpy(&word, row + x, 8);
+            h = rotl64(h ^ (word * kPrime2), 31) * kPrime1;
+        }
+        if (x < cols) {
+            uint64_t word = 0;
+            std::memcpy(&word, row + x, cols - x);
+            h = rotl64(h ^ (word * kPrime2), 31) * kPrime1;
+        }
+    }
+    return finalizeHash(h);
+}
+
+std::string AnalysisCache::entryPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.wmac", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(cacheDirectory) / name).string();
+}
+
+bool AnalysisCache::load(uint64_t key, cv::Size imageSize, int regionCount, int watermarkLength, Entry& entry) const {
+    if (!enabled() || regionCount <= 0 || watermarkLength <= 0) {
+        return false;
+    }
+    std::string path = entryPath(key);
+    std::error_code ec;
+    uint64_t fileSize = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    CacheFileHeader header;
+    if (!readArray(in, &header, 1)) {
+        return false;
+    }
+    if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version != kCacheVersion || header.key != key) {
+        libraryWarning() << "Warning: Ignoring mismatched analysis cache entry." << std::endl;
+        return false;
+    }
+    // ֻ÷ȫһµļ¼鳤ֵļͷ
+    if (header.width != imageSize.width || header.height != imageSize.height || header.regionCount != regionCount
+        || header.watermarkLength != watermarkLength || fileSize != sizeof(CacheFileHeader) + payloadBytes(regionCount, watermarkLength)) {
+        libraryWarning() << "Warning: Ignoring corrupt analysis cache entry." << std::endl;
+        return false;
+    }
+
+    const size_t hardWords = (static_cast<size_t>(header.watermarkLength) + 63) / 64;
+    std::vector<uint64_t> words(hardWords);
+    entry.hardBits.resize(header.regionCount);
+    for (int r = 0; r < header.regionCount; ++r) {
+        if (!readArray(in, words.data(), hardWords)) {
+            return false;
+        }
+        entry.hardBits[r].assignWords(words.data(), header.watermarkLength);
+    }
+    entry.softBits.resize(header.regionCount);
+    for (int r = 0; r < header.regionCount; ++r) {
+        entry.softBits[r].resize(header.watermarkLength);
+        if (!readArray(in, entry.softBits[r].data(), entry.softBits[r].size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AnalysisCache::store(uint64_t key, cv::Size imageSize, const Entry& entry) const {
+    if (!enabled()) {
+        return;
+    }
+    if (entry.hardBits.empty() || entry.softBits.size() != entry.hardBits.size()) {
+        throw std::invalid_argument("AnalysisCache: entry hard and soft bits do not match.");
+    }
+    const size_t watermarkLength = entry.hardBits[0].size();
+    for (size_t r = 0; r < entry.hardBits.size(); ++r) {
+        if (entry.hardBits[r].size() != watermarkLength || entry.softBits[r].size() != watermarkLength) {
+            throw std::invalid_argument("AnalysisCache: per-region bit lengths differ.");
+        }
+    }
+
+    CacheFileHeader header;
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    header.key = key;
+    header.width = imageSize.width;
+    header.height = imageSize.height;
+    header.regionCount = static_cast<int32_t>(entry.hardBits.size());
+    header.watermarkLength = static_cast<int32_t>(watermarkLength);
+
+    std::string path = entryPath(key);
+    // ʱļ׺ͬʱдͬһʱ
+    std::string tempPath = path + "." + std::to_string(std::random_device()()) + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            libraryWarning() << "Warning: Could not write analysis cache entry: " << tempPath << std::endl;
+            return;
+        }
+        writeArray(out, &header, 1);
+        for (const BitStream& bits : entry.hardBits) {
+            writeArray(out, bits.words().data(), bits.words().size());
+        }
+        for (const std::vector<double>& soft : entry.softBits) {
+            writeArray(out, soft.data(), soft.size());
+        }
+        if (!out) {
+            libraryWarning() << "Warning: Failed while writing analysis cache entry: " << tempPath << std::endl;
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        libraryWarning() << "Warning: Could not publish analysis cache entry: " << path << std::endl;
+        std::filesystem::remove(tempPath, ec);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+#include "BitStream.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// ѰַĴ̷ (ȡʹ)
+// Ϊ Y ͨݹϣȡϣֵΪӲ / о
+// ͬһļظɨʱֻһιϣȡļ
+// ļΪͷ +  (ֽ)ͨļȡ˳룻
+// ͷĳߴ硢λ÷ȫһ£ļҲ֮ΪδС
+class AnalysisCache {
+public:
+    // һ¼
+    struct Entry {
+        std::vector<BitStream> hardBits; // Ӳо
+        std::vector<std::vector<double>> softBits; // о
+    };
+
+    // directory Ϊձʾû
+    explicit AnalysisCache(const std::string& directory = "");
+
+    bool enabled() const { return !cacheDirectory.empty(); }
+    const std::string& getDirectory() const { return cacheDirectory; }
+
+    //  Y ͨ (CV_8UC1) ݹϣseed ֲ
+    static uint64_t hashImage(const cv::Mat& image, uint64_t seed);
+
+    // ϣֵ (ڰѲ)
+    static uint64_t combine(uint64_t seed, uint64_t value);
+
+    // ȡΪ key ļ¼ڡ𻵡 key ͼߴ硢ÿλ
+    //  imageSize / regionCount / watermarkLength һʱ false (ᰴļͷڴ)
+    bool load(uint64_t key, cv::Size imageSize, int regionCount, int watermarkLength, Entry& entry) const;
+
+    // дΪ key ļ¼ (дʱļдͬһʱ°ļ)
+    void store(uint64_t key, cv::Size imageSize, const Entry& entry) const;
+
+private:
+    std::string cacheDirectory;
+
+    std::string entryPath(uint64_t key) const;
+};
+
+#endif // ANALYSIS_CACHE_H
@@ -0,0 +1,198 @@
+#include "AsyncWatermarkService.h"
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+}
+
+AsyncWatermarkService::AsyncWatermarkService(int numWorkers, const WatermarkProfile& profile, bool quiet, const std::string& cacheDirectory)
+    : profile(profile), cacheDirectory(cacheDirectory), quiet(quiet), stopping(false) {
+    if (numWorkers <= 0) {
+        numWorkers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.emplace_back(&AsyncWatermarkService::workerLoop, this);
+    }
+}
+
+AsyncWatermarkService::~AsyncWatermarkService() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t AsyncWatermarkService::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return tasks.size();
+}
+
+void AsyncWatermarkService::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping) {
+            throw std::runtime_error("AsyncWatermarkService is shutting down.");
+        }
+        tasks.push_back(std::move(task));
+    }
+    queueCondition.notify_one();
+}
+
+void AsyncWatermarkService::workerLoop() {
+    ScopedLibraryLogMute mute(quiet);
+    WorkerContext context(profile, cacheDirectory);
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return; // stopping Ҷ
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task(context);
+    }
+}
+
+std::future<EmbedResult> AsyncWatermarkService::embedAsync(const cv::Mat& bgrImage, const std::string& watermarkText) {
+    auto promise = std::make_shared<std::promise<EmbedResult>>();
+    std::future<EmbedResult> future = promise->get_future();
+    Clock::time_point submitted = Clock::now();
+    submit([promise, bgrImage, watermarkText, submitted](WorkerContext& context) {
+        promise->set_value(runEmbed(context, bgrImage, "", "", watermarkText, elapsedMs(submitted)));
+    });
+    return future;
+}
+
+std::future<EmbedResult> AsyncWatermarkService::embedFileAsync(const std::string& inputPath, const std::string& outputPath, const std::string& watermarkText) {
+    auto promise = std::make_shared<std::promise<EmbedResult>>();
+    std::future<EmbedResult> future = promise->get_future();
+    Clock::time_point submitted = Clock::now();
+    submit([promise, inputPath, outputPath, watermarkText, submitted](WorkerContext& context) {
+        promise->set_value(runEmbed(context, cv::Mat(), inputPath, outputPath, watermarkText, elapsedMs(submitted)));
+    });
+    return future;
+}
+
+std::future<ExtractResult> AsyncWatermarkService::extractAsync(const cv::Mat& bgrImage) {
+    auto promise = std::make_shared<std::promise<ExtractResult>>();
+    std::future<ExtractResult> future = promise->get_future();
+    Clock::time_point submitted = Clock::now();
+    submit([promise, bgrImage, submitted](WorkerContext& context) {
+        promise->set_value(runExtract(context, bgrImage, "", elapsedMs(submitted)));
+    });
+    return future;
+}
+
+std::future<ExtractResult> AsyncWatermarkService::extractFileAsync(const std::string& inputPath) {
+    auto promise = std::make_shared<std::promise<ExtractResult>>();
+    std::future<ExtractResult> future = promise->get_future();
+    Clock::time_point submitted = Clock::now();
+    submit([promise, inputPath, submitted](WorkerContext& context) {
+        promise->set_value(runExtract(context, cv::Mat(), inputPath, elapsedMs(submitted)));
+    });
+    return future;
+}
+
+EmbedResult AsyncWatermarkService::runEmbed(WorkerContext& context, const cv::Mat& bgrImage, const std::string& inputPath,
+                                            const std::string& outputPath, const std::string& watermarkText, double queueMs) {
+    EmbedResult result;
+    result.timings.queueMs = queueMs;
+    Clock::time_point start = Clock::now();
+    try {
+        // 1. ȡת YCrCb
+        Clock::time_point stage = Clock::now();
+        cv::Mat inputImage = inputPath.empty() ? bgrImage : cv::imread(inputPath, cv::IMREAD_COLOR);
+        if (inputImage.empty() || inputImage.channels() != 3 || watermarkText.empty()) {
+            result.status = WatermarkStatus::InvalidInput;
+            result.message = inputImage.empty() ? "Could not load the input image." : "Input must be a BGR image and the watermark text non-empty.";
+            result.timings.totalMs = queueMs + elapsedMs(start);
+            return result;
+        }
+        cv::Mat yuvInput;
+        cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
+        std::vector<cv::Mat> yuvChannels;
+        cv::split(yuvInput, yuvChannels);
+        result.timings.decodeMs = elapsedMs(stage);
+
+        // 2. 
+        stage = Clock::now();
+        EmbeddingAnalysis analysis;
+        context.embedder.analyze(yuvChannels[0], analysis);
+        result.timings.analysisMs = elapsedMs(stage);
+
+        // 3. ˮӡ޸Ŀ
+        stage = Clock::now();
+        cv::Mat watermarkedY;
+        context.embedder.embed(analysis, watermarkText.substr(0, 8), watermarkedY);
+        result.timings.embedMs = elapsedMs(stage);
+
+        // 4. ת BGR (д)
+        stage = Clock::now();
+        yuvChannels[0] = watermarkedY;
+        cv::Mat watermarkedYUV;
+        cv::merge(yuvChannels, watermarkedYUV);
+        cv::cvtColor(watermarkedYUV, result.image, cv::COLOR_YCrCb2BGR);
+        if (!outputPath.empty() && !cv::imwrite(outputPath, result.image)) {
+            result.status = WatermarkStatus::Failed;
+            result.message = "Could not write the output image: " + outputPath;
+        } else {
+            result.status = WatermarkStatus::Ok;
+        }
+        result.timings.encodeMs = elapsedMs(stage);
+    } catch (const std::invalid_argument& e) {
+        result.status = WatermarkStatus::InvalidInput;
+        result.message = e.what();
+    } catch (const std::exception& e) {
+        result.status = WatermarkStatus::Failed;
+        result.message = e.what();
+    }
+    result.timings.totalMs = queueMs + elapsedMs(start);
+    return result;
+}
+
+ExtractResult AsyncWatermarkService::runExtract(WorkerContext& context, const cv::Mat& bgrImage, const std::string& inputPath, double queueMs) {
+    ExtractResult result;
+    result.timings.queueMs = queueMs;
+    Clock::time_point start = Clock::now();
+    try {
+        Clock::time_point stage = Clock::now();
+        cv::Mat inputImage = inputPath.empty() ? bgrImage : cv::imread(inputPath, cv::IMREAD_COLOR);
+        if (inputImage.empty() || inputImage.channels() != 3) {
+            result.status = WatermarkStatus::InvalidInput;
+            result.message = inputImage.empty() ? "Could not load the input image." : "Input must be a BGR image.";
+            result.timings.totalMs = queueMs + elapsedMs(start);
+            return result;
+        }
+        cv::Mat yuvInput;
+        cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
+        std::vector<cv::Mat> yuvChannels;
+        cv::split(yuvInput, yuvChannels);
+        result.timings.decodeMs = elapsedMs(stage);
+
+        // ȡ tryExtract ɣ analysis
+        stage = Clock::now();
+        bool found = context.extractor.tryExtract(yuvChannels[0], result.text, result.confidence);
+        result.timings.analysisMs = elapsedMs(stage);
+        result.status = found ? WatermarkStatus::Ok : WatermarkStatus::NotFound;
+        if (!found) {
+            result.message = "No valid watermark found.";
+        }
+    } catch (const std::exception& e) {
+        result.status = WatermarkStatus::Failed;
+        result.message = e.what();
+    }
+    result.timings.totalMs = queueMs + elapsedMs(start);
+    return result;
+}
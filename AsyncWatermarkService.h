@@ -0,0 +1,103 @@
+#ifndef ASYNC_WATERMARK_SERVICE_H
+#define ASYNC_WATERMARK_SERVICE_H
+
+#include "WatermarkEmbedder.h"
+#include "WatermarkExtractor.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// ״̬
+enum class WatermarkStatus {
+    Ok,           // ɹ (ȡʱʾҵЧˮӡ)
+    NotFound,     // ȡδͨλ RS 
+    InvalidInput, // Ч (ͼΪա޷ȡˮӡΪյ)
+    Failed        // г (ѡ޷дļ)
+};
+
+// ׶κʱ ()δĽ׶Ϊ 0
+struct StageTimings {
+    double queueMs = 0.0;    // ڶеȴ
+    double decodeMs = 0.0;   // ȡ / ͼת YCrCb
+    double analysisMs = 0.0; // Ƕ룺Ե⡢ѡ񡢿黮֣ȡıȡ
+    double embedMs = 0.0;    // Ƕ룺Ϳ޸ģȡͶƱ RS 
+    double encodeMs = 0.0;   // ת BGR  / дͼ
+    double totalMs = 0.0;    // ύ
+};
+
+struct EmbedResult {
+    WatermarkStatus status = WatermarkStatus::Failed;
+    std::string message; // ʱԭ
+    cv::Mat image; // ˮӡ BGR ͼ (дļҲ᷵)
+    StageTimings timings;
+};
+
+struct ExtractResult {
+    WatermarkStatus status = WatermarkStatus::Failed;
+    std::string message;
+    std::string text; // ˮӡ
+    double confidence = 0.0; // оŶ (0~1)
+    StageTimings timings;
+};
+
+// 첽Ƕ / ȡڲִɹ̶Ĺ߳ɣÿ̳߳ԤȵǶȡ
+// ŶӺ std::futureͬʱִ;ͬĽ롢׶ڸ߳صִС
+// Խṹʽأ쳣quiet ʱֻرձ߳ϵĿ־Ӱ÷̡߳
+// ʱŶӵ˳
+class AsyncWatermarkService {
+public:
+    // numWorkers <= 0 ʱȡӲ߳cacheDirectory ǿʱ̵߳ȡøô̷
+    explicit AsyncWatermarkService(int numWorkers = 0, const WatermarkProfile& profile = WatermarkProfile(), bool quiet = true,
+                                   const std::string& cacheDirectory = "");
+    ~AsyncWatermarkService();
+
+    AsyncWatermarkService(const AsyncWatermarkService&) = delete;
+    AsyncWatermarkService& operator=(const AsyncWatermarkService&) = delete;
+
+    // Ƕ뵽 BGR ͼ (ͼü÷ڽǰӦ޸)
+    std::future<EmbedResult> embedAsync(const cv::Mat& bgrImage, const std::string& watermarkText);
+    // ȡ inputPathǶд outputPath
+    std::future<EmbedResult> embedFileAsync(const std::string& inputPath, const std::string& outputPath, const std::string& watermarkText);
+
+    std::future<ExtractResult> extractAsync(const cv::Mat& bgrImage);
+    std::future<ExtractResult> extractFileAsync(const std::string& inputPath);
+
+    int getWorkerCount() const { return static_cast<int>(workers.size()); }
+    size_t getPendingCount() const;
+
+private:
+    // ÿ̵߳Ԥʵ ( workspace 뻺)
+    struct WorkerContext {
+        WatermarkEmbedder embedder;
+        WatermarkExtractor extractor;
+        WorkerContext(const WatermarkProfile& profile, const std::string& cacheDirectory) : embedder(profile), extractor(361, profile) {
+            extractor.setAnalysisCache(cacheDirectory);
+        }
+    };
+    typedef std::function<void(WorkerContext&)> Task;
+
+    WatermarkProfile profile;
+    std::string cacheDirectory;
+    bool quiet; // Ƿرչ̵߳Ŀ־
+    std::vector<std::thread> workers;
+    std::deque<Task> tasks;
+    mutable std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool stopping;
+
+    void submit(Task task);
+    void workerLoop();
+
+    static EmbedResult runEmbed(WorkerContext& context, const cv::Mat& bgrImage, const std::string& inputPath,
+                                const std::string& outputPath, const std::string& watermarkText, double queueMs);
+    static ExtractResult runExtract(WorkerContext& context, const cv::Mat& bgrImage, const std::string& inputPath, double queueMs);
+};
+
+#endif // ASYNC_WATERMARK_SERVICE_H
@@ -0,0 +1,163 @@
+#include "AttackSuite.h"
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+std::string Attack::name() const {
+    std::ostringstream text;
+    switch (kind) {
+    case Kind::None: return "none";
+    case Kind::Jpeg: text << "jpeg:"; break;
+    case Kind::Scale: text << "scale:"; break;
+    case Kind::Noise: text << "noise:"; break;
+    case Kind::Blur: text << "blur:"; break;
+    case Kind::Crop: text << "crop:"; break;
+    case Kind::H264: text << "h264:"; break;
+    }
+    text << parameter;
+    return text.str();
+}
+
+AttackSuite::AttackSuite(const std::string& workDirectory) : workDirectory(workDirectory) {
+    std::filesystem::create_directories(workDirectory);
+}
+
+std::vector<AttackChain> AttackSuite::parseChains(const std::string& spec) {
+    std::vector<AttackChain> chains;
+    std::stringstream chainList(spec);
+    std::string chainText;
+    while (std::getline(chainList, chainText, ',')) {
+        AttackChain chain;
+        std::stringstream attackList(chainText);
+        std::string attackText;
+        while (std::getline(attackList, attackText, '+')) {
+            size_t colon = attackText.find(':');
+            std::string kindName = attackText.substr(0, colon);
+            Attack attack;
+            if (kindName == "none") {
+                chain.push_back(attack);
+                continue;
+            }
+            if (colon == std::string::npos) {
+                throw std::invalid_argument("Attack needs a parameter: " + attackText);
+            }
+            try {
+                attack.parameter = std::stod(attackText.substr(colon + 1));
+            } catch (const std::exception&) {
+                throw std::invalid_argument("Invalid attack parameter: " + attackText);
+            }
+            if (kindName == "jpeg") attack.kind = Attack::Kind::Jpeg;
+            else if (kindName == "scale") attack.kind = Attack::Kind::Scale;
+            else if (kindName == "noise") attack.kind = Attack::Kind::Noise;
+            else if (kindName == "blur") attack.kind = Attack::Kind::Blur;
+            else if (kindName == "crop") attack.kind = Attack::Kind::Crop;
+            else if (kindName == "h264") attack.kind = Attack::Kind::H264;
+            else throw std::invalid_argument("Unknown attack: " + kindName);
+
+            bool valid = attack.parameter > 0;
+            if (attack.kind == Attack::Kind::Jpeg) valid = attack.parameter >= 1 && attack.parameter <= 100;
+            if (attack.kind == Attack::Kind::Crop) valid = attack.parameter >= 0 && attack.parameter < 0.5;
+            if (attack.kind == Attack::Kind::H264) valid = attack.parameter >= 0 && attack.parameter <= 51;
+            if (!valid) {
+                throw std::invalid_argument("Attack parameter out of range: " + attackText);
+            }
+            chain.push_back(attack);
+        }
+        if (!chain.empty()) {
+            chains.push_back(chain);
+        }
+    }
+    if (chains.empty()) {
+        throw std::invalid_argument("No attack chains specified.");
+    }
+    return chains;
+}
+
+std::string AttackSuite::chainName(const AttackChain& chain) {
+    std::string name;
+    for (const Attack& attack : chain) {
+        if (!name.empty()) name += "+";
+        name += attack.name();
+    }
+    return name;
+}
+
+cv::Mat AttackSuite::apply(const cv::Mat& bgrImage, const AttackChain& chain, uint64_t seed, int taskId) const {
+    cv::RNG rng(seed);
+    cv::Mat image = bgrImage;
+    for (const Attack& attack : chain) {
+        image = applyOne(image, attack, rng, taskId);
+    }
+    return image;
+}
+
+cv::Mat AttackSuite::applyOne(const cv::Mat& image, const Attack& attack, cv::RNG& rng, int taskId) const {
+    cv::Mat result;
+    switch (attack.kind) {
+    case Attack::Kind::None:
+        return image;
+    case Attack::Kind::Jpeg: {
+        std::vector<uchar> encoded;
+        cv::imencode(".jpg", image, encoded, { cv::IMWRITE_JPEG_QUALITY, static_cast<int>(attack.parameter) });
+        result = cv::imdecode(encoded, cv::IMREAD_COLOR);
+        break;
+    }
+    case Attack::Kind::Scale: {
+        cv::Mat scaled;
+        cv::resize(image, scaled, cv::Size(), attack.parameter, attack.parameter, attack.parameter < 1 ? cv::INTER_AREA : cv::INTER_LINEAR);
+        cv::resize(scaled, result, image.size(), 0, 0, cv::INTER_LINEAR);
+        break;
+    }
+    case Attack::Kind::Noise: {
+        cv::Mat noise(image.size(), CV_32FC3);
+        rng.fill(noise, cv::RNG::NORMAL, 0.0, attack.parameter);
+        cv::Mat noisy;
+        image.convertTo(noisy, CV_32F);
+        noisy += noise;
+        noisy.convertTo(result, CV_8U); // ͽضϵ [0, 255]
+        break;
+    }
+    case Attack::Kind::Blur:
+        cv::GaussianBlur(image, result, cv::Size(), attack.parameter);
+        break;
+    case Attack::Kind::Crop: {
+        int dx = static_cast<int>(image.cols * attack.parameter);
+        int dy = static_cast<int>(image.rows * attack.parameter);
+        result = image(cv::Rect(dx, dy, image.cols - dx, image.rows - dy)).clone();
+        break;
+    }
+    case Attack::Kind::H264:
+        result = reencodeH264(image, static_cast<int>(attack.parameter), taskId);
+        break;
+    }
+    if (result.empty()) {
+        throw std::runtime_error("Attack " + attack.name() + " produced an empty image.");
+    }
+    return result;
+}
+
+cv::Mat AttackSuite::reencodeH264(const cv::Mat& image, int crf, int taskId) const {
+    std::string prefix = workDirectory + "/task_" + std::to_string(taskId);
+    std::string inputPath = prefix + "_in.png";
+    std::string videoPath = prefix + ".mp4";
+    std::string outputPath = prefix + "_out.png";
+    if (!cv::imwrite(inputPath, image)) {
+        throw std::runtime_error("Could not write " + inputPath);
+    }
+    // yuv420p Ҫżߴ磺Ȳߣûԭߴ
+    std::string encode = "ffmpeg -y -v error -i \"" + inputPath + "\" -vf \"pad=ceil(iw/2)*2:ceil(ih/2)*2\" -c:v libx264 -crf "
+                       + std::to_string(crf) + " -pix_fmt yuv420p \"" + videoPath + "\"";
+    std::string decode = "ffmpeg -y -v error -i \"" + videoPath + "\" -frames:v 1 \"" + outputPath + "\"";
+    if (system(encode.c_str()) != 0 || system(decode.c_str()) != 0) {
+        throw std::runtime_error("ffmpeg H.264 re-encode failed (is ffmpeg with libx264 on the PATH?).");
+    }
+    cv::Mat decoded = cv::imread(outputPath, cv::IMREAD_COLOR);
+    std::remove(inputPath.c_str());
+    std::remove(videoPath.c_str());
+    std::remove(outputPath.c_str());
+    if (decoded.empty() || decoded.cols < image.cols || decoded.rows < image.rows) {
+        throw std::runtime_error("Could not read back the H.264 re-encoded frame.");
+    }
+    return decoded(cv::Rect(0, 0, image.cols, image.rows)).clone();
+}
@@ -0,0 +1,52 @@
+#ifndef ATTACK_SUITE_H
+#define ATTACK_SUITE_H
+
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// ³Բõĵ
+struct Attack {
+    enum class Kind {
+        None,     // 
+        Jpeg,     // JPEG ѹΪ (1~100)
+        Scale,    // Żԭߴ磬Ϊ
+        Noise,    // Ը˹Ϊ׼ (Ҷȼ)
+        Blur,     // ˹ģΪ sigma ()
+        Crop,     // õߺϱߣΪõĿ / ߱
+        H264      //  ffmpeg  libx264 رһ֡Ϊ CRF
+    };
+    Kind kind = Kind::None;
+    double parameter = 0.0;
+
+    std::string name() const;
+};
+
+// ʩӵɹ ( JPEG )
+typedef std::vector<Attack> AttackChain;
+
+class AttackSuite {
+public:
+    // workDirectory  H.264 رʱļ (ʱ)
+    explicit AttackSuite(const std::string& workDirectory = "temp_attacks");
+
+    // б"none,jpeg:75,scale:0.5+jpeg:90,h264:28"
+    // ŷָ'+' ͬһʩӵĹʽʱ׳ std::invalid_argument
+    static std::vector<AttackChain> parseChains(const std::string& spec);
+    static std::string chainName(const AttackChain& chain);
+
+    //  BGR ͼʩӹseed  (ͬһ seed ɸ)
+    // taskId ֲʱļ
+    cv::Mat apply(const cv::Mat& bgrImage, const AttackChain& chain, uint64_t seed, int taskId) const;
+
+    // ĬϹ
+    static const char* defaultSpec() { return "none,jpeg:90,jpeg:75,jpeg:50,scale:0.75,noise:3,blur:1,crop:0.02,h264:28"; }
+
+private:
+    std::string workDirectory;
+
+    cv::Mat applyOne(const cv::Mat& image, const Attack& attack, cv::RNG& rng, int taskId) const;
+    cv::Mat reencodeH264(const cv::Mat& image, int crf, int taskId) const;
+};
+
+#endif // ATTACK_SUITE_H
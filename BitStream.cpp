@@ -0,0 +1,212 @@
+#include "BitStream.h"
+#include <bitset>
+#include <stdexcept>
+#include <algorithm>
+
+BitStream::BitStream(size_t numBits, int value)
+    : wordData(wordCount(numBits), value ? ~uint64_t(0) : 0), bitCount(numBits) {
+    clearTail();
+}
+
+int BitStream::popcount(uint64_t word) {
+    // std::bitset::count ϻ popcnt ָ
+    return static_cast<int>(std::bitset<64>(word).count());
+}
+
+void BitStream::clearTail() {
+    size_t tailBits = bitCount & 63;
+    if (tailBits != 0 && !wordData.empty()) {
+        wordData.back() &= (uint64_t(1) << tailBits) - 1;
+    }
+}
+
+void BitStream::assignWords(const uint64_t* words, size_t numBits) {
+    bitCount = numBits;
+    wordData.assign(words, words + wordCount(numBits));
+    clearTail();
+}
+
+void BitStream::push_back(int bit) {
+    if ((bitCount & 63) == 0) {
+        wordData.push_back(0);
+    }
+    ++bitCount;
+    set(bitCount - 1, bit);
+}
+
+void BitStream::appendByte(uint8_t byte) {
+    size_t pos = bitCount;
+    resize(bitCount + 8, 0);
+    for (int b = 0; b < 8; ++b) {
+        if ((byte >> (7 - b)) & 1) {
+            set(pos + b, 1);
+        }
+    }
+}
+
+uint8_t BitStream::byteAt(size_t bitPos) const {
+    uint8_t value = 0;
+    for (int b = 0; b < 8; ++b) {
+        value = static_cast<uint8_t>((value << 1) | get(bitPos + b));
+    }
+    return value;
+}
+
+void BitStream::resize(size_t numBits, int value) {
+    if (numBits <= bitCount) {
+        bitCount = numBits;
+        wordData.resize(wordCount(numBits));
+        clearTail();
+        return;
+    }
+    append(numBits - bitCount, value);
+}
+
+void BitStream::append(size_t numBits, int value) {
+    if (numBits == 0) return;
+    size_t oldCount = bitCount;
+    bitCount += numBits;
+    wordData.resize(wordCount(bitCount), value ? ~uint64_t(0) : 0);
+    if (value) {
+        // ɵһβԭΪ 0Ҫ 1
+        size_t tailBits = oldCount & 63;
+        if (tailBits != 0) {
+            wordData[oldCount >> 6] |= ~((uint64_t(1) << tailBits) - 1);
+        }
+    }
+    clearTail();
+}
+
+void BitStream::append(const BitStream& other) {
+    if (other.empty()) return;
+    size_t shift = bitCount & 63;
+    if (shift == 0) {
+        // ֶ룺ֱӿ
+        wordData.insert(wordData.end(), other.wordData.begin(), other.wordData.end());
+        bitCount += other.bitCount;
+        return;
+    }
+    size_t oldCount = bitCount;
+    bitCount += other.bitCount;
+    wordData.resize(wordCount(bitCount), 0);
+    size_t dst = oldCount >> 6;
+    for (size_t w = 0; w < other.wordData.size(); ++w) {
+        uint64_t word = other.wordData[w];
+        wordData[dst + w] |= word << shift;
+        if (dst + w + 1 < wordData.size()) {
+            wordData[dst + w + 1] |= word >> (64 - shift);
+        }
+    }
+    clearTail();
+}
+
+BitStream BitStream::fromBytes(const std::string& bytes) {
+    BitStream bits(bytes.size() * 8, 0);
+    for (size_t k = 0; k < bytes.size(); ++k) {
+        unsigned char ch = static_cast<unsigned char>(bytes[k]);
+        // ÿֽڸλǰ
+        for (int b = 0; b < 8; ++b) {
+            if ((ch >> (7 - b)) & 1) {
+                bits.set(k * 8 + b, 1);
+            }
+        }
+    }
+    return bits;
+}
+
+void BitStream::toBytes(std::string& bytes) const {
+    size_t numBytes = bitCount / 8;
+    bytes.resize(numBytes);
+    for (size_t k = 0; k < numBytes; ++k) {
+        unsigned char c = 0;
+        for (int b = 0; b < 8; ++b) {
+            c |= static_cast<unsigned char>(get(k * 8 + b) << (7 - b));
+        }
+        bytes[k] = static_cast<char>(c);
+    }
+}
+
+std::string BitStream::toBytes() const {
+    std::string bytes;
+    toBytes(bytes);
+    return bytes;
+}
+
+size_t BitStream::countOnes(size_t pos, size_t len) const {
+    if (pos + len > bitCount) {
+        throw std::out_of_range("BitStream: countOnes range exceeds stream size.");
+    }
+    if (len == 0) return 0;
+
+    size_t first = pos >> 6;
+    size_t last = (pos + len - 1) >> 6;
+    uint64_t headMask = ~uint64_t(0) << (pos & 63);
+    size_t endBits = (pos + len) & 63;
+    uint64_t tailMask = endBits ? ((uint64_t(1) << endBits) - 1) : ~uint64_t(0);
+
+    if (first == last) {
+        return popcount(wordData[first] & headMask & tailMask);
+    }
+    size_t count = popcount(wordData[first] & headMask);
+    for (size_t w = first + 1; w < last; ++w) {
+        count += popcount(wordData[w]);
+    }
+    count += popcount(wordData[last] & tailMask);
+    return count;
+}
+
+BitStream BitStream::atLeast(const std::vector<BitStream>& streams, int threshold) {
+    BitStream result;
+    atLeast(streams, threshold, result);
+    return result;
+}
+
+void BitStream::atLeast(const std::vector<BitStream>& streams, int threshold, BitStream& result) {
+    if (streams.empty()) {
+        result.clear();
+        return;
+    }
+    size_t numBits = streams[0].size();
+    for (const auto& s : streams) {
+        if (s.size() != numBits) {
+            throw std::invalid_argument("BitStream: Streams for voting must have equal length.");
+        }
+    }
+    // ÿֶᱻ帲ǣֻ (㹻ʱ)
+    result.wordData.resize(wordCount(numBits));
+    result.bitCount = numBits;
+    if (threshold <= 0 || threshold > static_cast<int>(streams.size())) {
+        std::fill(result.wordData.begin(), result.wordData.end(), threshold <= 0 ? ~uint64_t(0) : 0);
+        result.clearTail();
+        return;
+    }
+
+    // λƬcounter[j] ÿһλǶӦƱĵ j λ
+    int planes = 1;
+    while ((size_t(1) << planes) <= streams.size()) ++planes;
+
+    uint64_t counter[64];
+    for (size_t w = 0; w < result.wordData.size(); ++w) {
+        std::fill(counter, counter + planes, 0);
+        for (const auto& s : streams) {
+            uint64_t carry = s.wordData[w];
+            for (int j = 0; j < planes && carry; ++j) {
+                uint64_t next = counter[j] & carry;
+                counter[j] ^= carry;
+                carry = next;
+            }
+        }
+        // λȽ counter >= threshold (Ӹλƽ浽λƽ)
+        uint64_t greater = 0, equal = ~uint64_t(0);
+        for (int j = planes - 1; j >= 0; --j) {
+            if ((threshold >> j) & 1) {
+                equal &= counter[j];
+            } else {
+                greater |= equal & counter[j];
+                equal &= ~counter[j];
+            }
+        }
+        result.wordData[w] = greater | equal;
+    }
+    result.clearTail();
+}
@@ -0,0 +1,93 @@
+#ifndef BIT_STREAM_H
+#define BIT_STREAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// λѹ洢ˮӡ (ÿ 64 λһ uint64 )
+//  i λ words[i / 64] ĵ (i % 64) λ size() βλʼΪ 0
+class BitStream {
+public:
+    // ֻõõ 0  1
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = int;
+
+        const_iterator(const BitStream* stream, size_t pos) : owner(stream), index(pos) {}
+        int operator*() const { return owner->get(index); }
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++index; return tmp; }
+        bool operator==(const const_iterator& other) const { return index == other.index && owner == other.owner; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        const BitStream* owner;
+        size_t index;
+    };
+
+    BitStream() : bitCount(0) {}
+    explicit BitStream(size_t numBits, int value = 0);
+
+    size_t size() const { return bitCount; }
+    bool empty() const { return bitCount == 0; }
+
+    int get(size_t i) const { return static_cast<int>((wordData[i >> 6] >> (i & 63)) & 1u); }
+    int operator[](size_t i) const { return get(i); }
+    void set(size_t i, int bit) {
+        uint64_t mask = uint64_t(1) << (i & 63);
+        if (bit) wordData[i >> 6] |= mask; else wordData[i >> 6] &= ~mask;
+    }
+
+    void push_back(int bit);
+    void appendByte(uint8_t byte); // ׷ 8 λλǰ
+    uint8_t byteAt(size_t bitPos) const; // ȡ bitPos ʼ 8 λλǰ
+    void reserve(size_t numBits) { wordData.reserve(wordCount(numBits)); }
+    void resize(size_t numBits, int value = 0);
+    void clear() { wordData.clear(); bitCount = 0; }
+
+    // ׷һα / ׷ n ͬλ
+    void append(const BitStream& other);
+    void append(size_t numBits, int value);
+
+    // ֽڴת (ÿֽڸλǰ)
+    static BitStream fromBytes(const std::string& bytes);
+    std::string toBytes() const;
+    void toBytes(std::string& bytes) const;
+
+    // ͳ [pos, pos + len) Χ 1 ĸ ( popcount)
+    size_t countOnes(size_t pos, size_t len) const;
+    size_t countOnes() const { return countOnes(0, bitCount); }
+
+    // λͳƶȳ 1 ƱƱ >= threshold λΪ 1 ı (ֲ)
+    static BitStream atLeast(const std::vector<BitStream>& streams, int threshold);
+    // ͬϣд result ()
+    static void atLeast(const std::vector<BitStream>& streams, int threshold, BitStream& result);
+
+    const std::vector<uint64_t>& words() const { return wordData; }
+
+    // ðִŵ滻 ( words() ͬ)
+    void assignWords(const uint64_t* words, size_t numBits);
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, bitCount); }
+
+    bool operator==(const BitStream& other) const { return bitCount == other.bitCount && wordData == other.wordData; }
+    bool operator!=(const BitStream& other) const { return !(*this == other); }
+
+private:
+    static size_t wordCount(size_t numBits) { return (numBits + 63) >> 6; }
+    static int popcount(uint64_t word);
+    void clearTail(); //  size() ֮βλ
+
+    std::vector<uint64_t> wordData;
+    size_t bitCount;
+};
+
+#endif // BIT_STREAM_H
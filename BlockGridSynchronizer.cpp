@@ -0,0 +1,133 @@
+#include "BlockGridSynchronizer.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+BlockGridSynchronizer::BlockGridSynchronizer(BlockProcessor& blockProcessor, int searchRadius)
+    : blockProcessor(blockProcessor), searchRadius(searchRadius) {
+    if (searchRadius < 0) {
+        throw std::invalid_argument("Grid search radius cannot be negative.");
+    }
+}
+
+void BlockGridSynchronizer::setSearchRadius(int radius) {
+    if (radius < 0) {
+        throw std::invalid_argument("Grid search radius cannot be negative.");
+    }
+    searchRadius = radius;
+}
+
+GridAlignment BlockGridSynchronizer::align(const cv::Mat& image, const EdgeBitmap& edgeBitmap, const cv::Rect& regionBounds,
+                                           int watermarkLength, FrameWorkspace& workspace) {
+    if (image.empty() || image.type() != CV_8UC1 || image.size() != edgeBitmap.size()) {
+        throw std::invalid_argument("BlockGridSynchronizer: Image must be CV_8UC1 and match the edge bitmap.");
+    }
+    if ((regionBounds & cv::Rect(0, 0, image.cols, image.rows)) != regionBounds) {
+        throw std::invalid_argument("BlockGridSynchronizer: Region lies outside the image.");
+    }
+
+    GridAlignment result;
+    if (searchRadius == 0) {
+        return result;
+    }
+
+    // 1. Ŀ黮 (ȡʱһ)
+    blockProcessor.prepareBlocks(image(regionBounds), edgeBitmap, regionBounds, watermarkLength, workspace, layoutBlocks);
+
+    // 2. Χƽƺ򲻳ͼ
+    int dxMin = -std::min(searchRadius, regionBounds.x);
+    int dyMin = -std::min(searchRadius, regionBounds.y);
+    int dxMax = std::min(searchRadius, image.cols - regionBounds.x - regionBounds.width);
+    int dyMax = std::min(searchRadius, image.rows - regionBounds.y - regionBounds.height);
+    cv::Rect searchBounds(regionBounds.x + dxMin, regionBounds.y + dyMin,
+                          regionBounds.width + dxMax - dxMin, regionBounds.height + dyMax - dyMin);
+
+    // 3. ΧԵصĻͼλõĿֵͱԵ O(1)
+    cv::integral(image(searchBounds), pixelIntegral, CV_64F);
+    edgeIntegral.create(searchBounds.height + 1, searchBounds.width + 1, CV_32S);
+    edgeIntegral.row(0).setTo(cv::Scalar(0));
+    for (int y = 0; y < searchBounds.height; ++y) {
+        const int* above = edgeIntegral.ptr<int>(y);
+        int* current = edgeIntegral.ptr<int>(y + 1);
+        current[0] = 0;
+        int rowSum = 0;
+        for (int x = 0; x < searchBounds.width; ++x) {
+            rowSum += edgeBitmap.get(searchBounds.y + y, searchBounds.x + x) ? 1 : 0;
+            current[x + 1] = above[x + 1] + rowSum;
+        }
+    }
+
+    const int dftRows = cv::getOptimalDFTSize(searchBounds.height);
+    const int dftCols = cv::getOptimalDFTSize(searchBounds.width);
+    const double edgeSigma = blockProcessor.calculateBlockStrength(true);
+    const double flatSigma = blockProcessor.calculateBlockStrength(false);
+    const int edgeThreshold = blockProcessor.getEdgeThreshold();
+
+    // 4. ĩ / ĩеĿߴ粻ͬߴ ( 4 )ֱֵͼ״ģ壬Ƶغۼӡ
+    // ֻĿʱƽԼȫƥ䣻ϳߴ粻ͬĩ / ĩпʵƫƲΨһֵ
+    std::vector<cv::Size> blockSizes;
+    for (const ImageBlock& block : layoutBlocks) {
+        if (std::find(blockSizes.begin(), blockSizes.end(), block.bounds.size()) == blockSizes.end()) {
+            blockSizes.push_back(block.bounds.size());
+        }
+    }
+    correlationSpectrum.create(dftRows, dftCols, CV_32FC2);
+    correlationSpectrum.setTo(cv::Scalar::all(0));
+    for (const cv::Size& blockSize : blockSizes) {
+        // ÿѡĶֵ -cos(2*pi*mean/sigma)sigma ɸλõĿǷΪԵ
+        const int mapRows = searchBounds.height - blockSize.height + 1;
+        const int mapCols = searchBounds.width - blockSize.width + 1;
+        const double blockArea = static_cast<double>(blockSize.area());
+        alignmentMap.create(dftRows, dftCols, CV_32F);
+        alignmentMap.setTo(cv::Scalar(0));
+        cv::parallel_for_(cv::Range(0, mapRows), [&](const cv::Range& range) {
+            for (int y = range.start; y < range.end; ++y) {
+                const double* pixelTop = pixelIntegral.ptr<double>(y);
+                const double* pixelBottom = pixelIntegral.ptr<double>(y + blockSize.height);
+                const int* edgeTop = edgeIntegral.ptr<int>(y);
+                const int* edgeBottom = edgeIntegral.ptr<int>(y + blockSize.height);
+                float* value = alignmentMap.ptr<float>(y);
+                for (int x = 0; x < mapCols; ++x) {
+                    int x1 = x + blockSize.width;
+                    double mean = (pixelBottom[x1] - pixelBottom[x] - pixelTop[x1] + pixelTop[x]) / blockArea;
+                    int edgeCount = edgeBottom[x1] - edgeBottom[x] - edgeTop[x1] + edgeTop[x];
+                    double sigma = edgeCount > edgeThreshold ? edgeSigma : flatSigma;
+                    value[x] = static_cast<float>(-std::cos(2.0 * CV_PI * mean / sigma));
+                }
+            }
+        });
+
+        // ״ģ壺 (Ͻ) Ϊ 1
+        blockComb.create(dftRows, dftCols, CV_32F);
+        blockComb.setTo(cv::Scalar(0));
+        for (const ImageBlock& block : layoutBlocks) {
+            if (block.bounds.size() == blockSize) {
+                blockComb.at<float>(block.bounds.y, block.bounds.x) = 1.0f;
+            }
+        }
+
+        // correlation(s) = sum_t comb(t) * map(t + s)
+        //  t ߴߴ磬t + s ֵͼߴ磬Чƫڲѭ
+        cv::dft(alignmentMap, mapSpectrum, cv::DFT_COMPLEX_OUTPUT);
+        cv::dft(blockComb, combSpectrum, cv::DFT_COMPLEX_OUTPUT);
+        cv::mulSpectrums(mapSpectrum, combSpectrum, mapSpectrum, 0, true);
+        correlationSpectrum += mapSpectrum;
+    }
+    cv::idft(correlationSpectrum, correlation, cv::DFT_REAL_OUTPUT | cv::DFT_SCALE);
+    const double blockCount = static_cast<double>(layoutBlocks.size());
+
+    // 5. Чƫȡֵ÷ͬʱƽ
+    result.zeroOffsetScore = correlation.at<float>(-dyMin, -dxMin) / blockCount;
+    result.score = result.zeroOffsetScore;
+    for (int sy = 0; sy <= dyMax - dyMin; ++sy) {
+        const float* row = correlation.ptr<float>(sy);
+        for (int sx = 0; sx <= dxMax - dxMin; ++sx) {
+            double score = row[sx] / blockCount;
+            if (score > result.score) {
+                result.score = score;
+                result.offset = cv::Point(sx + dxMin, sy + dyMin);
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,47 @@
+#ifndef BLOCK_GRID_SYNCHRONIZER_H
+#define BLOCK_GRID_SYNCHRONIZER_H
+
+#include "BlockProcessor.h"
+#include "EdgeBitmap.h"
+#include "FrameWorkspace.h"
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// 
+struct GridAlignment {
+    cv::Point offset; // ӦƽƵ
+    double score = 0.0; // ƫƴƽ÷֣Χ [-1, 1]1 ʾп DC е
+    double zeroOffsetScore = 0.0; // ƽʱĵ÷ (Ա)
+};
+
+// ͬͼ񱻲üƽƼغٶ룬ȡʧܡ
+// Ƕʱÿ DC е (mean / sigma СΪ 0.5ˮӡλ޹)
+//  -cos(2*pi*mean/sigma) ڶĿΪ 1δǶλϽ
+// Χÿѡֵ (ʽֵɻͼõ)״ģ FFT أ
+// һεõкѡƫƵĵ÷֣ȡߣֻ֮ڸƫƴȡһΡ
+class BlockGridSynchronizer {
+public:
+    BlockGridSynchronizer(BlockProcessor& blockProcessor, int searchRadius = 16);
+
+    //  regionBounds Χ searchRadius ƫ (ƽƺ֤ͼ)
+    GridAlignment align(const cv::Mat& image, const EdgeBitmap& edgeBitmap, const cv::Rect& regionBounds,
+                        int watermarkLength, FrameWorkspace& workspace);
+
+    int getSearchRadius() const { return searchRadius; }
+    void setSearchRadius(int radius);
+
+private:
+    BlockProcessor& blockProcessor;
+    int searchRadius;
+
+    std::vector<ImageBlock> layoutBlocks; // Ŀ黮 (ֻλ)
+    cv::Mat pixelIntegral; // ΧصĻͼ (CV_64F)
+    cv::Mat edgeIntegral; // ΧڱԵصĻͼ (CV_32S)
+    cv::Mat alignmentMap; // ĳһߴÿѡĶֵ (CV_32F㵽 DFT ߴ)
+    cv::Mat blockComb; // ͬߴ״ģ (CV_32F)
+    cv::Mat mapSpectrum, combSpectrum; // ߵƵ
+    cv::Mat correlationSpectrum; // ߴ绥Ƶ֮
+    cv::Mat correlation; // ѡƫƵĵ÷֮
+};
+
+#endif // BLOCK_GRID_SYNCHRONIZER_H
@@ -20,6 +20,11 @@ int BlockProcessor::countEdgePixels(const cv::Mat& blockEdgePatch) {
     return cv::countNonZero(blockEdgePatch);
 }
 
+// ͬϣ popcount
+int BlockProcessor::countEdgePixels(const EdgeBitmap& edgeBitmap, const cv::Rect& blockBounds) {
+    return edgeBitmap.countRect(blockBounds);
+}
+
 // ȷ̶Ե N*_xy (ʽ 12)
 int BlockProcessor::determineFixedEdgeCount(int actualEdgeCount) {
     return (actualEdgeCount <= edgeBlockThreshold) ? 0 : edgeBlockThreshold;
@@ -51,10 +56,32 @@ double BlockProcessor::calculateEmbeddingStrength(int fixedEdgeCount) {
     return baseStrength * adaptiveFactor;
 }
 
+double BlockProcessor::calculateBlockStrength(bool isEdgeBlock) {
+    return calculateEmbeddingStrength(isEdgeBlock ? edgeBlockThreshold : 0);
+}
+
 // Ϊ飬 (Ӧ Step 4)
 std::vector<ImageBlock> BlockProcessor::prepareBlocks(const cv::Mat& regionPatch, const cv::Mat& regionEdgePatch, int watermarkLength) {
+    FrameWorkspace workspace;
+    std::vector<ImageBlock> blocks;
+    prepareBlocks(regionPatch, regionEdgePatch, watermarkLength, workspace, blocks);
+    return blocks;
+}
+
+void BlockProcessor::prepareBlocks(const cv::Mat& regionPatch, const cv::Mat& regionEdgePatch, int watermarkLength, FrameWorkspace& workspace, std::vector<ImageBlock>& blocks) {
     if (regionPatch.empty() || regionEdgePatch.empty() || regionPatch.size() != regionEdgePatch.size()) {
         throw std::runtime_error("BlockProcessor: Input patches for block preparation are invalid or mismatched.");
+    }
+    EdgeBitmap edgeBitmap;
+    edgeBitmap.fromMat(regionEdgePatch);
+    prepareBlocks(regionPatch, edgeBitmap, cv::Rect(0, 0, regionEdgePatch.cols, regionEdgePatch.rows), watermarkLength, workspace, blocks);
+}
+
+void BlockProcessor::prepareBlocks(const cv::Mat& regionPatch, const EdgeBitmap& edgeBitmap, const cv::Rect& regionBounds, int watermarkLength, FrameWorkspace& workspace, std::vector<ImageBlock>& blocks) {
+    if (regionPatch.empty() || regionPatch.size() != regionBounds.size()
+        || regionBounds.x < 0 || regionBounds.y < 0
+        || regionBounds.x + regionBounds.width > edgeBitmap.cols() || regionBounds.y + regionBounds.height > edgeBitmap.rows()) {
+        throw std::runtime_error("BlockProcessor: Input patches for block preparation are invalid or mismatched.");
     }
      if (watermarkLength <= 0) {
          throw std::invalid_argument("BlockProcessor: Watermark length must be positive.");
@@ -98,7 +125,7 @@ std::vector<ImageBlock> BlockProcessor::prepareBlocks(const cv::Mat& regionPatch
          throw std::runtime_error("BlockProcessor: Region size is too small to be divided into blocks.");
     }
 
-    std::vector<ImageBlock> blocks;
+    blocks.clear();
     blocks.reserve(watermarkLength);
 
     int blockIndex = 0;
@@ -113,11 +140,18 @@ std::vector<ImageBlock> BlockProcessor::prepareBlocks(const cv::Mat& regionPatch
 
             block.bounds = cv::Rect(startX, startY, currentBlockWidth, currentBlockHeight);
 
-            // ȡӦıԵͼ
-            cv::Mat blockEdgePatch = regionEdgePatch(block.bounds);
+            blocks.push_back(block);
+            blockIndex++;
+        }
+    }
+
+    // Ĳֻȡأ鲢м
+    cv::parallel_for_(cv::Range(0, static_cast<int>(blocks.size())), [&](const cv::Range& range) {
+        for (int k = range.start; k < range.end; ++k) {
+            ImageBlock& block = blocks[k];
 
-            //  N_xy
-            block.edgePixelCount = countEdgePixels(blockEdgePatch);
+            //  N_xy (ͼԵλͼеλ = ƫ + ƫ)
+            block.edgePixelCount = countEdgePixels(edgeBitmap, block.bounds + regionBounds.tl());
 
             //  N*_xy жǷΪԵ
             block.fixedEdgePixelCount = determineFixedEdgeCount(block.edgePixelCount);
@@ -126,21 +160,22 @@ std::vector<ImageBlock> BlockProcessor::prepareBlocks(const cv::Mat& regionPatch
             //  sigma_xy
             block.embeddingStrength = calculateEmbeddingStrength(block.fixedEdgePixelCount);
 
-            // ǱԵ飬Ԥ˹Ȩ (ʽ 17)
-            if (block.isEdgeBlock) {
-                block.modificationWeights = calculateGaussianWeights(block.bounds.height, block.bounds.width, gaussSigma);
-            }
+            // ԭʼ DC ϵ (ʽ 13)ˮӡλ޹أǶˮӡʱãȡʱֱо
+            block.dcCoefficient = calculateDCCoefficient(regionPatch(block.bounds));
+        }
+    });
 
-            blocks.push_back(block);
-            blockIndex++;
+    // ǱԵ飬ȡ˹Ȩ (ʽ 17)ͬߴĿ鹲 workspace лͬһֻȨ
+    // workspace Ȩػ̰߳ȫڲж֮
+    for (ImageBlock& block : blocks) {
+        if (block.isEdgeBlock) {
+            block.modificationWeights = workspace.gaussianWeights(block.bounds.height, block.bounds.width, gaussSigma);
         }
     }
      if (blocks.size() != watermarkLength) {
          // ͨӦ÷ǿ黮߼
          throw std::runtime_error("BlockProcessor: Number of prepared blocks does not match watermark length.");
      }
-
-    return blocks;
 }
 
 
@@ -253,6 +288,88 @@ cv::Mat BlockProcessor::calculatePixelModifications(const ImageBlock& block, con
     return modificationMatrix; // ص double ͵޸
 }
 
+// 㲢ֱӦõ޸ (ʽ 13-16)м
+void BlockProcessor::applyPixelModifications(const ImageBlock& block, const cv::Mat& blockPatch, int watermarkBit, cv::Mat& targetPatch) {
+     if (blockPatch.empty() || blockPatch.size() != block.bounds.size() || targetPatch.size() != block.bounds.size()) {
+         throw std::runtime_error("Block patch size mismatch in applyPixelModifications.");
+     }
+     if (blockPatch.channels() != 1 || targetPatch.type() != CV_64F) {
+         throw std::runtime_error("Block patch must be single-channel grayscale and target must be CV_64F.");
+     }
+
+    // صľֵת CV_32F ֵһ£ʡȥת
+    double dcCoefficient = calculateDCCoefficient(blockPatch);
+    double quantizedDCCoefficient = calculateQuantizedDCCoefficient(dcCoefficient, block.embeddingStrength, block.bounds.width, block.bounds.height, watermarkBit);
+    double totalModification = calculateTotalModification(dcCoefficient, quantizedDCCoefficient, block.bounds.width, block.bounds.height);
+
+    int rows = block.bounds.height;
+    int cols = block.bounds.width;
+    if (!block.isEdgeBlock) {
+        // ǱԵ飺ƽ
+        double modificationPerPixel = totalModification / (rows * cols);
+        for (int i = 0; i < rows; ++i) {
+            double* target = targetPatch.ptr<double>(i);
+            for (int j = 0; j < cols; ++j) {
+                target[j] += modificationPerPixel;
+            }
+        }
+    } else {
+        // Ե飺˹Ȩط
+        const cv::Mat& gaussianWeights = block.modificationWeights;
+        if (gaussianWeights.empty() || gaussianWeights.size() != cv::Size(cols, rows) || gaussianWeights.type() != CV_64F) {
+             throw std::runtime_error("Invalid Gaussian weights provided for edge block modification distribution.");
+        }
+        for (int i = 0; i < rows; ++i) {
+            const double* weight = gaussianWeights.ptr<double>(i);
+            double* target = targetPatch.ptr<double>(i);
+            for (int j = 0; j < cols; ++j) {
+                target[j] += weight[j] * totalModification;
+            }
+        }
+    }
+}
+
+// û DC ϵ޸ֱд 8 λ (ʽ 14-16)
+void BlockProcessor::writeModifiedBlock(const ImageBlock& block, const cv::Mat& blockPatch, int watermarkBit, cv::Mat& outputPatch) {
+     if (blockPatch.size() != block.bounds.size() || outputPatch.size() != block.bounds.size()) {
+         throw std::runtime_error("Block patch size mismatch in writeModifiedBlock.");
+     }
+     if (blockPatch.type() != CV_8UC1 || outputPatch.type() != CV_8UC1) {
+         throw std::runtime_error("Block patch and output patch must be CV_8UC1.");
+     }
+
+    double quantizedDCCoefficient = calculateQuantizedDCCoefficient(block.dcCoefficient, block.embeddingStrength, block.bounds.width, block.bounds.height, watermarkBit);
+    double totalModification = calculateTotalModification(block.dcCoefficient, quantizedDCCoefficient, block.bounds.width, block.bounds.height);
+
+    int rows = block.bounds.height;
+    int cols = block.bounds.width;
+    if (!block.isEdgeBlock) {
+        // ǱԵ飺ƽ
+        double modificationPerPixel = totalModification / (rows * cols);
+        for (int i = 0; i < rows; ++i) {
+            const uchar* source = blockPatch.ptr<uchar>(i);
+            uchar* output = outputPatch.ptr<uchar>(i);
+            for (int j = 0; j < cols; ++j) {
+                output[j] = cv::saturate_cast<uchar>(source[j] + modificationPerPixel);
+            }
+        }
+    } else {
+        // Ե飺˹Ȩط
+        const cv::Mat& gaussianWeights = block.modificationWeights;
+        if (gaussianWeights.empty() || gaussianWeights.size() != cv::Size(cols, rows) || gaussianWeights.type() != CV_64F) {
+             throw std::runtime_error("Invalid Gaussian weights provided for edge block modification distribution.");
+        }
+        for (int i = 0; i < rows; ++i) {
+            const double* weight = gaussianWeights.ptr<double>(i);
+            const uchar* source = blockPatch.ptr<uchar>(i);
+            uchar* output = outputPatch.ptr<uchar>(i);
+            for (int j = 0; j < cols; ++j) {
+                output[j] = cv::saturate_cast<uchar>(source[j] + weight[j] * totalModification);
+            }
+        }
+    }
+}
+
 // ʵ processRegionAsBlock
 ImageBlock BlockProcessor::processRegionAsBlock(const cv::Mat& blockPatch, const cv::Mat& blockEdgePatch, const cv::Rect& blockBounds) {
     if (blockPatch.empty() || blockEdgePatch.empty() || blockPatch.size() != blockEdgePatch.size()) {
@@ -2,6 +2,7 @@
 #define BLOCK_PROCESSOR_H
 
 #include "utils.h"
+#include "FrameWorkspace.h"
 #include <vector>
 #include <opencv2/opencv.hpp>
 
@@ -13,6 +14,12 @@ public:
     // Ϊ飬 (Ӧ Step 4)
     std::vector<ImageBlock> prepareBlocks(const cv::Mat& regionPatch, const cv::Mat& regionEdgePatch, int watermarkLength);
 
+    // ͬϣд blocks ()Եĸ˹Ȩش workspace ȡ
+    void prepareBlocks(const cv::Mat& regionPatch, const cv::Mat& regionEdgePatch, int watermarkLength, FrameWorkspace& workspace, std::vector<ImageBlock>& blocks);
+
+    // ͬϣԵֱͼİλѹԵͼϰ (regionBounds Ϊͼеλ)
+    void prepareBlocks(const cv::Mat& regionPatch, const EdgeBitmap& edgeBitmap, const cv::Rect& regionBounds, int watermarkLength, FrameWorkspace& workspace, std::vector<ImageBlock>& blocks);
+
     // /飬 (ڼʵ)
     ImageBlock processRegionAsBlock(const cv::Mat& blockPatch, const cv::Mat& blockEdgePatch, const cv::Rect& blockBounds);
 
@@ -20,15 +27,28 @@ public:
     // ÿص޸ w_xy(i,j)
     cv::Mat calculatePixelModifications(const ImageBlock& block, const cv::Mat& blockPatch, int watermarkBit);
 
+    // ͬϣ޸ֱۼӵ targetPatch (CV_64F) ϣм޸ľ
+    void applyPixelModifications(const ImageBlock& block, const cv::Mat& blockPatch, int watermarkBit, cv::Mat& targetPatch);
+
+    // ʹ prepareBlocks  DC ϵ޸ blockPatch + ޸ (ȡ) д outputPatch (CV_8U)
+    //  applyPixelModifications ۼӵ CV_64F ת 8 λȫһ
+    void writeModifiedBlock(const ImageBlock& block, const cv::Mat& blockPatch, int watermarkBit, cv::Mat& outputPatch);
+
     // ȷ DC  public 
     double calculateDCCoefficient(const cv::Mat& blockPatch);
 
+    // Ե / ǱԵڱֵ Th µǶǿ sigma_xy (ʽ 11, 12)
+    double calculateBlockStrength(bool isEdgeBlock);
+
+    int getEdgeThreshold() const { return edgeBlockThreshold; }
+
 private:
     int edgeBlockThreshold; // Th
     double gaussSigma; // ˹׼
 
     // ıԵ N_xy (ʽ 8)
     int countEdgePixels(const cv::Mat& blockEdgePatch);
+    int countEdgePixels(const EdgeBitmap& edgeBitmap, const cv::Rect& blockBounds);
 
     // ȷ̶Ե N*_xy (ʽ 12)
     int determineFixedEdgeCount(int actualEdgeCount);
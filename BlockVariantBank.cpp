@@ -0,0 +1,71 @@
+#include "BlockVariantBank.h"
+#include "WatermarkEmbedder.h"
+#include <cstring>
+#include <stdexcept>
+
+void BlockVariantBank::build(const EmbeddingAnalysis& analysis, BlockProcessor& blockProcessor) {
+    if (analysis.empty()) {
+        throw std::invalid_argument("Embedding analysis is empty.");
+    }
+
+    originalImage = analysis.originalImage;
+    watermarkLength = analysis.watermarkLength;
+    blockSlots.clear();
+    variantData.clear();
+
+    // ȷÿλúƫƣһԷ洢
+    size_t totalBytes = 0;
+    for (size_t regionIdx = 0; regionIdx < analysis.regions.size(); ++regionIdx) {
+        const cv::Rect& regionBounds = analysis.regions[regionIdx].bounds;
+        const std::vector<ImageBlock>& blocks = analysis.regionBlocks[regionIdx];
+        for (const ImageBlock& block : blocks) {
+            BlockSlot slot;
+            slot.bounds = block.bounds + regionBounds.tl();
+            slot.offset = totalBytes;
+            blockSlots.push_back(slot);
+            totalBytes += 2 * static_cast<size_t>(block.bounds.area());
+        }
+    }
+    variantData.resize(totalBytes);
+
+    // ֱ壬ֱд洢Ĵ洢ص鲢
+    cv::parallel_for_(cv::Range(0, static_cast<int>(blockSlots.size())), [&](const cv::Range& range) {
+        for (int slotIdx = range.start; slotIdx < range.end; ++slotIdx) {
+            const BlockSlot& slot = blockSlots[slotIdx];
+            const ImageBlock& block = analysis.regionBlocks[slotIdx / watermarkLength][slotIdx % watermarkLength];
+            cv::Mat blockPatch = originalImage(slot.bounds);
+            for (int bit = 0; bit <= 1; ++bit) {
+                uchar* data = &variantData[slot.offset + bit * static_cast<size_t>(slot.bounds.area())];
+                cv::Mat variant(slot.bounds.height, slot.bounds.width, CV_8UC1, data);
+                blockProcessor.writeModifiedBlock(block, blockPatch, bit, variant);
+            }
+        }
+    });
+}
+
+void BlockVariantBank::assemble(const BitStream& watermarkBits, cv::Mat& outputImage) const {
+    if (empty()) {
+        throw std::runtime_error("Block variant bank has not been built.");
+    }
+    if (watermarkBits.size() != static_cast<size_t>(watermarkLength)) {
+        throw std::runtime_error("Encoded watermark length does not match the variant bank.");
+    }
+
+    originalImage.copyTo(outputImage);
+
+    size_t bitIdx = 0;
+    for (const BlockSlot& slot : blockSlots) {
+        int bit = watermarkBits[bitIdx];
+        if (++bitIdx == watermarkBits.size()) {
+            bitIdx = 0;
+        }
+
+        const int rows = slot.bounds.height;
+        const int cols = slot.bounds.width;
+        const uchar* source = &variantData[slot.offset + bit * static_cast<size_t>(rows) * cols];
+        for (int i = 0; i < rows; ++i) {
+            std::memcpy(outputImage.ptr<uchar>(slot.bounds.y + i) + slot.bounds.x, source, cols);
+            source += cols;
+        }
+    }
+}
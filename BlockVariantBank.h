@@ -0,0 +1,44 @@
+#ifndef BLOCK_VARIANT_BANK_H
+#define BLOCK_VARIANT_BANK_H
+
+#include "BitStream.h"
+#include "BlockProcessor.h"
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+struct EmbeddingAnalysis;
+
+// ⣺ÿ޸ֻȡڿݺǶλ
+// ԤÿǶ 0 Ƕ 1  8 λ
+// ֮ÿˮӡֻ谴λѶӦпͼ (memcpy ٶ)
+// ɺֻɱ߳ͬʱ assemble
+class BlockVariantBank {
+public:
+    BlockVariantBank() : watermarkLength(0) {}
+
+    // ݷԤȫ    ֱ
+    void build(const EmbeddingAnalysis& analysis, BlockProcessor& blockProcessor);
+
+    // ˮӡװͼ (CV_8Uߴ粻ʱڴ)
+    //  WatermarkEmbedder::embed ȫһ
+    void assemble(const BitStream& watermarkBits, cv::Mat& outputImage) const;
+
+    bool empty() const { return blockSlots.empty(); }
+    int getWatermarkLength() const { return watermarkLength; }
+
+    // ռõֽ
+    size_t getMemoryBytes() const { return variantData.size(); }
+
+private:
+    struct BlockSlot {
+        cv::Rect bounds; // ͼеλ
+        size_t offset; // Ƕ 0 ı variantData е㣬Ƕ 1 ı
+    };
+
+    cv::Mat originalImage; // ԭʼ Y ͨ (ֱ)
+    std::vector<BlockSlot> blockSlots; //     ˳УŶ watermarkLength ȡģ
+    std::vector<uchar> variantData; // б尴
+    int watermarkLength;
+};
+
+#endif // BLOCK_VARIANT_BANK_H
@@ -0,0 +1,82 @@
+#include "EdgeBitmap.h"
+#include <bitset>
+#include <stdexcept>
+
+int EdgeBitmap::popcount(uint64_t word) {
+    // std::bitset::count ϻ popcnt ָ
+    return static_cast<int>(std::bitset<64>(word).count());
+}
+
+void EdgeBitmap::create(int rows, int cols) {
+    if (rows < 0 || cols < 0) {
+        throw std::invalid_argument("EdgeBitmap: Size cannot be negative.");
+    }
+    numRows = rows;
+    numCols = cols;
+    wordsPerRow = (cols + 63) / 64;
+    wordData.assign(static_cast<size_t>(rows) * wordsPerRow, 0);
+}
+
+int EdgeBitmap::countRect(const cv::Rect& rect) const {
+    if (rect.x < 0 || rect.y < 0 || rect.width < 0 || rect.height < 0
+        || rect.x + rect.width > numCols || rect.y + rect.height > numRows) {
+        throw std::out_of_range("EdgeBitmap: Rect is outside the bitmap.");
+    }
+    if (rect.width == 0 || rect.height == 0) {
+        return 0;
+    }
+
+    int firstWord = rect.x >> 6;
+    int lastWord = (rect.x + rect.width - 1) >> 6;
+    uint64_t firstMask = ~uint64_t(0) << (rect.x & 63);
+    int endBit = (rect.x + rect.width) & 63;
+    uint64_t lastMask = endBit == 0 ? ~uint64_t(0) : (uint64_t(1) << endBit) - 1;
+
+    int count = 0;
+    for (int y = rect.y; y < rect.y + rect.height; ++y) {
+        const uint64_t* row = rowWords(y);
+        if (firstWord == lastWord) {
+            count += popcount(row[firstWord] & firstMask & lastMask);
+            continue;
+        }
+        count += popcount(row[firstWord] & firstMask);
+        for (int w = firstWord + 1; w < lastWord; ++w) {
+            count += popcount(row[w]);
+        }
+        count += popcount(row[lastWord] & lastMask);
+    }
+    return count;
+}
+
+int EdgeBitmap::countAll() const {
+    int count = 0;
+    for (uint64_t word : wordData) {
+        count += popcount(word);
+    }
+    return count;
+}
+
+void EdgeBitmap::fromMat(const cv::Mat& edgeImage) {
+    if (edgeImage.type() != CV_8UC1) {
+        throw std::invalid_argument("EdgeBitmap: Edge image must be CV_8UC1.");
+    }
+    create(edgeImage.rows, edgeImage.cols);
+    for (int y = 0; y < numRows; ++y) {
+        const uchar* source = edgeImage.ptr<uchar>(y);
+        uint64_t* row = rowWords(y);
+        for (int x = 0; x < numCols; ++x) {
+            row[x >> 6] |= static_cast<uint64_t>(source[x] != 0) << (x & 63);
+        }
+    }
+}
+
+void EdgeBitmap::toMat(cv::Mat& edgeImage) const {
+    edgeImage.create(numRows, numCols, CV_8U);
+    for (int y = 0; y < numRows; ++y) {
+        const uint64_t* row = rowWords(y);
+        uchar* target = edgeImage.ptr<uchar>(y);
+        for (int x = 0; x < numCols; ++x) {
+            target[x] = ((row[x >> 6] >> (x & 63)) & 1u) ? 255 : 0;
+        }
+    }
+}
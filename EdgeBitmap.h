@@ -0,0 +1,51 @@
+#ifndef EDGE_BITMAP_H
+#define EDGE_BITMAP_H
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// λѹĶֵԵͼÿ 1 λÿа uint64 ֶ
+//  y е x д rowWords(y)[x / 64] ĵ (x % 64) λÿг cols βλʼΪ 0
+// ڴΪ CV_8U Եͼ 1/8ڱԵؼ popcount
+class EdgeBitmap {
+public:
+    EdgeBitmap() : numRows(0), numCols(0), wordsPerRow(0) {}
+
+    // óߴ粢 (ߴ粻ʱڴ)
+    void create(int rows, int cols);
+
+    int rows() const { return numRows; }
+    int cols() const { return numCols; }
+    bool empty() const { return numRows == 0 || numCols == 0; }
+    cv::Size size() const { return cv::Size(numCols, numRows); }
+    int getWordsPerRow() const { return wordsPerRow; }
+
+    uint64_t* rowWords(int y) { return &wordData[static_cast<size_t>(y) * wordsPerRow]; }
+    const uint64_t* rowWords(int y) const { return &wordData[static_cast<size_t>(y) * wordsPerRow]; }
+    std::vector<uint64_t>& words() { return wordData; }
+    const std::vector<uint64_t>& words() const { return wordData; }
+
+    bool get(int y, int x) const { return (rowWords(y)[x >> 6] >> (x & 63)) & 1u; }
+    void set(int y, int x) { rowWords(y)[x >> 6] |= uint64_t(1) << (x & 63); }
+
+    // ͳƾڵıԵ ( popcountβȡ)
+    int countRect(const cv::Rect& rect) const;
+    int countAll() const;
+
+    //  CV_8U Եͼת (ΪԵתʱԵΪ 255)
+    void fromMat(const cv::Mat& edgeImage);
+    void toMat(cv::Mat& edgeImage) const;
+
+    size_t getMemoryBytes() const { return wordData.size() * sizeof(uint64_t); }
+
+private:
+    static int popcount(uint64_t word);
+
+    int numRows;
+    int numCols;
+    int wordsPerRow;
+    std::vector<uint64_t> wordData;
+};
+
+#endif // EDGE_BITMAP_H
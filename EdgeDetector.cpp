@@ -1,38 +1,74 @@
 #include "EdgeDetector.h"
 #include "utils.h" // Ҫ DCT/IDCT
+#include <algorithm>
 
-EdgeDetector::EdgeDetector(double lowThresh, double highThresh, double postProcessThresh)
-    : cannyLowThreshold(lowThresh), cannyHighThreshold(highThresh), postProcessingThreshold(postProcessThresh) {}
+EdgeDetector::EdgeDetector(double lowThresh, double highThresh, double postProcessThresh, int stripeHeight, int haloRows)
+    : cannyLowThreshold(lowThresh), cannyHighThreshold(highThresh), postProcessingThreshold(postProcessThresh),
+      stripeRows(0), stripeHaloRows(0) {
+    setParallelStripes(stripeHeight, haloRows);
+}
+
+void EdgeDetector::setParallelStripes(int stripeHeight, int haloRows) {
+    if (haloRows < 0) {
+        throw std::invalid_argument("EdgeDetector: Halo rows cannot be negative.");
+    }
+    stripeRows = stripeHeight;
+    stripeHaloRows = haloRows;
+}
 
 cv::Mat EdgeDetector::detectEdges(const cv::Mat& originalImage) {
+    FrameWorkspace workspace;
+    return detectEdges(originalImage, workspace);
+}
+
+cv::Mat EdgeDetector::detectEdges(const cv::Mat& originalImage, FrameWorkspace& workspace) {
+    const EdgeBitmap& edgeBitmap = detectEdgeBitmap(originalImage, workspace);
+    cv::Mat& finalEdges = workspace.buffer(FrameWorkspace::EdgeFinal, originalImage.rows, originalImage.cols, CV_8U);
+    edgeBitmap.toMat(finalEdges);
+    return finalEdges;
+}
+
+const EdgeBitmap& EdgeDetector::detectEdgeBitmap(const cv::Mat& originalImage, FrameWorkspace& workspace) {
     if (originalImage.empty() || originalImage.channels() != 1) {
         throw std::runtime_error("EdgeDetector: Input image must be a single-channel grayscale image.");
     }
 
-    // Step 1.1: Ԥ
-    cv::Mat preprocessedImage = preProcess(originalImage);
+    // Step 1.1: Ԥ (ȫ DCT ȫֹһ޷ִ)
+    cv::Mat preprocessedImage = preProcess(originalImage, workspace);
+
+    EdgeBitmap& finalEdges = workspace.edgeBitmap();
+    finalEdges.create(originalImage.rows, originalImage.cols);
+
+    // Step 1.2 + 1.3:  (߶ȹ̶߳޹)
+    if (stripeRows > 0 && originalImage.rows > stripeRows) {
+        detectEdgesInStripes(preprocessedImage, originalImage, workspace, finalEdges);
+        return finalEdges;
+    }
 
     // Step 1.2: Canny Ե
-    cv::Mat cannyEdges;
+    cv::Mat& cannyEdges = workspace.buffer(FrameWorkspace::EdgeCanny, originalImage.rows, originalImage.cols, CV_8U);
     cv::Canny(preprocessedImage, cannyEdges, cannyLowThreshold, cannyHighThreshold);
 
     // Step 1.3: 
-    cv::Mat finalEdges = postProcess(cannyEdges, originalImage); // ע⣺ʹԭʼͼҶȲ
+    postProcess(cannyEdges, originalImage, finalEdges); // ע⣺ʹԭʼͼҶȲ
 
     return finalEdges;
 }
 
 // ԤDCT
-cv::Mat EdgeDetector::preProcess(const cv::Mat& image) {
+cv::Mat EdgeDetector::preProcess(const cv::Mat& image, FrameWorkspace& workspace) {
     // ޸ΪCV_64F
-    cv::Mat floatImage;
+    cv::Mat& floatImage = workspace.buffer(FrameWorkspace::EdgeFloatImage, image.rows, image.cols, CV_64F);
     image.convertTo(floatImage, CV_64F);
 
-    //  DCT
-    cv::Mat dctCoeffs = calculateDCT(floatImage);    // --- ӦDCTϵԣŻ汾---
+    //  DCT (ֱд븴õϵ)
+    cv::Mat& dctCoeffs = workspace.buffer(FrameWorkspace::EdgeDCTCoeffs, image.rows, image.cols, CV_64F);
+    cv::dct(floatImage, dctCoeffs);    // --- ӦDCTϵԣŻ汾---
     int rows = dctCoeffs.rows;
     int cols = dctCoeffs.cols;
-    std::vector<std::pair<double*, double>> acCoeffData; // (ָ, ֵ)
+    std::vector<std::pair<double*, double>>& acCoeffData = workspace.acCoefficients(); // (ָ, ֵ)
+    acCoeffData.clear();
+    acCoeffData.reserve(static_cast<size_t>(rows) * cols);
 
     // ACϵķȷӦֵ
     double mean = 0.0, variance = 0.0;
@@ -84,25 +120,30 @@ cv::Mat EdgeDetector::preProcess(const cv::Mat& image) {
             retentionRatio = 0.05 + 0.05 * (variance / (mean * mean));
         }
         
-        // ֵ򣬱ֵϴϵȱҪϵ
-        std::sort(acCoeffData.begin(), acCoeffData.end(), 
-                 [](const std::pair<double*, double>& a, const std::pair<double*, double>& b) {
-                     return a.second > b.second;
-                 });
-        
-        // Сϵ
+        // ֵ򻮷ֵ֣ϴϵȱҪϵ
+        // ֻҳ k ķֽ磬nth_element Ϊ O(N)ضϵõ㼯ͬ (ֵϵȡܲͬ)
         int numToZero = static_cast<int>(acCoeffData.size() * (1.0 - retentionRatio));
-        for (int i = acCoeffData.size() - numToZero; i < acCoeffData.size(); ++i) {
+        int keepCount = static_cast<int>(acCoeffData.size()) - numToZero;
+        if (numToZero > 0) {
+            std::nth_element(acCoeffData.begin(), acCoeffData.begin() + keepCount, acCoeffData.end(),
+                     [](const std::pair<double*, double>& a, const std::pair<double*, double>& b) {
+                         return a.second > b.second;
+                     });
+        }
+
+        // Сϵ
+        for (int i = keepCount; i < acCoeffData.size(); ++i) {
             *(acCoeffData[i].first) = 0.0;
         }
     }
     // --- ӦDCTϵ ---
 
     //  IDCT
-    cv::Mat idctResult = calculateIDCT(dctCoeffs);
+    cv::Mat& idctResult = workspace.buffer(FrameWorkspace::EdgeIDCTResult, rows, cols, CV_64F);
+    cv::idct(dctCoeffs, idctResult);
 
     // ת 8λ޷ͣнض
-    cv::Mat processedImage;
+    cv::Mat& processedImage = workspace.buffer(FrameWorkspace::EdgePreprocessed, rows, cols, CV_8U);
     idctResult.convertTo(processedImage, CV_8U);
     cv::normalize(processedImage, processedImage, 0, 255, cv::NORM_MINMAX);
 
@@ -110,10 +151,25 @@ cv::Mat EdgeDetector::preProcess(const cv::Mat& image) {
 }
 
 // ȥԵ (ʽ 1)
-cv::Mat EdgeDetector::postProcess(const cv::Mat& edgeImage, const cv::Mat& originalImage) {
-    cv::Mat processedEdges = edgeImage.clone(); // ޸
+void EdgeDetector::postProcess(const cv::Mat& edgeImage, const cv::Mat& originalImage, EdgeBitmap& processedEdges) {
+    postProcessRows(edgeImage, originalImage, processedEdges, 0, edgeImage.rows);
+}
+
+//  [rowStart, rowEnd) ִʽ 1 ĺ
+void EdgeDetector::postProcessRows(const cv::Mat& edgeImage, const cv::Mat& originalImage, EdgeBitmap& processedEdges, int rowStart, int rowEnd) {
+    // Ȱ Canny λд (ĩ/вԭ)
+    for (int r = rowStart; r < rowEnd; ++r) {
+        const uchar* source = edgeImage.ptr<uchar>(r);
+        uint64_t* row = processedEdges.rowWords(r);
+        std::fill(row, row + processedEdges.getWordsPerRow(), uint64_t(0));
+        for (int c = 0; c < edgeImage.cols; ++c) {
+            row[c >> 6] |= static_cast<uint64_t>(source[c] != 0) << (c & 63);
+        }
+    }
 
-    for (int r = 1; r < edgeImage.rows - 1; ++r) {
+    // ͼĩ/в (ͼа汾һ)
+    for (int r = std::max(rowStart, 1); r < std::min(rowEnd, edgeImage.rows - 1); ++r) {
+        uint64_t* row = processedEdges.rowWords(r);
         for (int c = 1; c < edgeImage.cols - 1; ++c) {
             // ֻ Canny ⵽ıԵ (ֵΪ 255)
             if (edgeImage.at<uchar>(r, c) == 255) {
@@ -133,10 +189,46 @@ cv::Mat EdgeDetector::postProcess(const cv::Mat& edgeImage, const cv::Mat& origi
 
                 // ƽСֵ tΪ죬Ϊ 0
                 if (avgDiff < postProcessingThreshold) {
-                    processedEdges.at<uchar>(r, c) = 0;
+                    row[c >> 6] &= ~(uint64_t(1) << (c & 63));
                 }
             }
         }
     }
-    return processedEdges;
+}
+
+// е Canny + 
+// ÿ [y0 - halo, y1 + halo) ϶ Cannyֻ [y0, y1)
+// Sobel Ǽֵֻ 2 Уhalo >= 3 ʱеݶжͼһ£
+// ֻͺֵͨԣԵ halo ֮ǿԵ ( halo ߽ĸ
+// ɵαǿԵԵ)Ľͼ Canny ͬ
+// ߽總Խ halo еԵϣhalo ԽԽӽͼ
+// ֻ 3x3 ԭͼҶȣ봮ȫһ¡
+// ÿаֶ룬дֻص
+void EdgeDetector::detectEdgesInStripes(const cv::Mat& preprocessedImage, const cv::Mat& originalImage, FrameWorkspace& workspace, EdgeBitmap& finalEdges) {
+    int rows = preprocessedImage.rows;
+    int cols = preprocessedImage.cols;
+    int numStripes = (rows + stripeRows - 1) / stripeRows;
+
+    cv::Mat& cannyEdges = workspace.buffer(FrameWorkspace::EdgeCanny, rows, cols, CV_8U);
+
+    // ÿʹøԵ Canny д뻥ص
+    std::vector<cv::Mat>& stripeBuffers = workspace.stripeBuffers();
+    if (stripeBuffers.size() < static_cast<size_t>(numStripes)) {
+        stripeBuffers.resize(numStripes);
+    }
+
+    cv::parallel_for_(cv::Range(0, numStripes), [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; ++s) {
+            int y0 = s * stripeRows;
+            int y1 = std::min(rows, y0 + stripeRows);
+            int haloStart = std::max(0, y0 - stripeHaloRows);
+            int haloEnd = std::min(rows, y1 + stripeHaloRows);
+
+            cv::Mat& stripeEdges = stripeBuffers[s];
+            cv::Canny(preprocessedImage.rowRange(haloStart, haloEnd), stripeEdges, cannyLowThreshold, cannyHighThreshold);
+            stripeEdges.rowRange(y0 - haloStart, y1 - haloStart).copyTo(cannyEdges.rowRange(y0, y1));
+
+            postProcessRows(cannyEdges, originalImage, finalEdges, y0, y1);
+        }
+    });
 }
@@ -1,27 +1,50 @@
 #ifndef EDGE_DETECTOR_H
 #define EDGE_DETECTOR_H
 
+#include "FrameWorkspace.h"
 #include <opencv2/opencv.hpp>
 
 class EdgeDetector {
 public:
     // 캯Դ Canny ֵֵ t
-    EdgeDetector(double lowThresh = 50, double highThresh = 150, double postProcessThresh = 30.0);
+    // stripeHeight > 0 ʱ÷УCanny ͺ stripeHeight һִ̳߳У
+    // ÿ¸ haloRows еص ( detectEdgesInStripes ˵)
+    // ֤봮λһ£δʵ 1080p / 4K ϲ (self-check stripes ֻϳͼϵĲ)
+    // ˲Ϊţ÷ʱǶȡ˱ʹͬ
+    EdgeDetector(double lowThresh = 50, double highThresh = 150, double postProcessThresh = 30.0, int stripeHeight = 0, int haloRows = 32);
+
+    // ÷в (stripeHeight <= 0 ʾ)
+    void setParallelStripes(int stripeHeight, int haloRows = 32);
 
     // ִбԵ (Ӧ Step 1)
     // ؾȷԵͼ (ֵͼ, ԵΪ255, ǱԵΪ0)
     cv::Mat detectEdges(const cv::Mat& originalImage);
 
+    // ͬϣм workspace Ļ (صıԵͼһεʱᱻ)
+    cv::Mat detectEdges(const cv::Mat& originalImage, FrameWorkspace& workspace);
+
+    // ͬϣֱӷغİλѹԵͼ (workspace.edgeBitmap())չ CV_8U
+    const EdgeBitmap& detectEdgeBitmap(const cv::Mat& originalImage, FrameWorkspace& workspace);
+
 private:
     // ԤDCT
-    cv::Mat preProcess(const cv::Mat& image);
+    cv::Mat preProcess(const cv::Mat& image, FrameWorkspace& workspace);
+
+    // ȥԵλд processedEdges
+    void postProcess(const cv::Mat& edgeImage, const cv::Mat& originalImage, EdgeBitmap& processedEdges);
+
+    //  [rowStart, rowEnd) ִкд processedEdges ͬ
+    // (ÿаֶ룬лɷ)
+    void postProcessRows(const cv::Mat& edgeImage, const cv::Mat& originalImage, EdgeBitmap& processedEdges, int rowStart, int rowEnd);
 
-    // ȥԵ
-    cv::Mat postProcess(const cv::Mat& edgeImage, const cv::Mat& originalImage);
+    // ִ Canny + 
+    void detectEdgesInStripes(const cv::Mat& preprocessedImage, const cv::Mat& originalImage, FrameWorkspace& workspace, EdgeBitmap& finalEdges);
 
     double cannyLowThreshold;
     double cannyHighThreshold;
     double postProcessingThreshold; // ֵ t
+    int stripeRows; // ÿ (<= 0 ʾ)
+    int stripeHaloRows; // ÿµص
 };
 
 #endif // EDGE_DETECTOR_H
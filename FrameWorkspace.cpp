@@ -0,0 +1,20 @@
+#include "FrameWorkspace.h"
+
+cv::Mat& FrameWorkspace::buffer(Slot slot, int rows, int cols, int type) {
+    cv::Mat& buf = buffers[slot];
+    if (buf.rows != rows || buf.cols != cols || buf.type() != type) {
+        buf.create(rows, cols, type);
+        allocationCount++;
+    }
+    return buf;
+}
+
+const cv::Mat& FrameWorkspace::gaussianWeights(int rows, int cols, double sigma) {
+    auto key = std::make_tuple(rows, cols, sigma);
+    auto it = gaussianWeightCache.find(key);
+    if (it == gaussianWeightCache.end()) {
+        it = gaussianWeightCache.emplace(key, calculateGaussianWeights(rows, cols, sigma)).first;
+        allocationCount++;
+    }
+    return it->second;
+}
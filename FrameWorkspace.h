@@ -0,0 +1,63 @@
+#ifndef FRAME_WORKSPACE_H
+#define FRAME_WORKSPACE_H
+
+#include "utils.h"
+#include "EdgeBitmap.h"
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// ֡õʱ (Ƕ / ȡ·ʹ)
+// ÿλһ֡СĻߴͲʱֱӸã
+// ֱͬʵ֡Ԥ֮Щ·䡣OpenCV ڲʱڴ
+// ( Canny ݶͼparallel_for_ ) ڴУÿ֡Ի䡣
+// ̰߳ȫÿ߳ / ÿǶȡʵһ
+class FrameWorkspace {
+public:
+    enum Slot {
+        EdgeFloatImage = 0,  // EdgeDetector: CV_64F 
+        EdgeDCTCoeffs,       // EdgeDetector: DCT ϵ
+        EdgeIDCTResult,      // EdgeDetector: IDCT 
+        EdgePreprocessed,    // EdgeDetector: ȥ 8 λͼ
+        EdgeCanny,           // EdgeDetector: Canny 
+        EdgeFinal,           // EdgeDetector: ıԵͼ
+        RegionFloatPatch,    // RegionScorer: ڵĸ㸱
+        RegionDiffSquared,   // RegionScorer: м
+        SlotCount
+    };
+
+    FrameWorkspace() : allocationCount(0) {}
+
+    // ȡָλĻߴͱ仯ʱ· ()
+    cv::Mat& buffer(Slot slot, int rows, int cols, int type);
+
+    // ȡ (rows, cols, sigma) ĸ˹Ȩ (ʽ 17)ֻ
+    const cv::Mat& gaussianWeights(int rows, int cols, double sigma);
+
+    // ɸõ
+    std::vector<std::pair<double*, double>>& acCoefficients() { return acCoeffData; }
+    std::vector<Region>& candidateRegions() { return candidates; }
+    std::vector<Region>& selectedRegions() { return selected; }
+    std::vector<ImageBlock>& blocks() { return blockList; }
+    std::vector<cv::Mat>& stripeBuffers() { return stripes; } // ʱÿһ±꼴
+    EdgeBitmap& edgeBitmap() { return edgeBits; } // EdgeDetector İλѹԵͼ
+
+    //  / Ȩػδжۼƴ (ȷԤȺ󱾳زٷ)
+    size_t getAllocationCount() const { return allocationCount; }
+    void resetAllocationCount() { allocationCount = 0; }
+
+private:
+    cv::Mat buffers[SlotCount];
+    std::map<std::tuple<int, int, double>, cv::Mat> gaussianWeightCache;
+    std::vector<std::pair<double*, double>> acCoeffData;
+    std::vector<Region> candidates;
+    std::vector<Region> selected;
+    std::vector<ImageBlock> blockList;
+    std::vector<cv::Mat> stripes;
+    EdgeBitmap edgeBits;
+    size_t allocationCount;
+};
+
+#endif // FRAME_WORKSPACE_H
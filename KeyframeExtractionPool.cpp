@@ -0,0 +1,63 @@
+#include "KeyframeExtractionPool.h"
+#include "WatermarkExtractor.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+KeyframeExtractionPool::KeyframeExtractionPool(int expectedWatermarkLength, const WatermarkProfile& profile, int numWorkers)
+    : expectedWatermarkLength(expectedWatermarkLength), profile(profile),
+      workerCount(numWorkers > 0 ? numWorkers : std::max(1, cv::getNumThreads())) {
+    if (expectedWatermarkLength <= 0) {
+        throw std::invalid_argument("Expected watermark length must be positive.");
+    }
+}
+
+void KeyframeExtractionPool::run(const std::vector<std::string>& framePaths, const std::vector<int>& frameNumbers,
+                                 const std::function<void(const KeyframeResult&)>& onResult) {
+    if (framePaths.size() != frameNumbers.size()) {
+        throw std::invalid_argument("Frame paths and frame numbers must have the same length.");
+    }
+    const int frameCount = static_cast<int>(framePaths.size());
+    std::vector<KeyframeResult> results(frameCount);
+    std::vector<char> finished(frameCount, 0);
+    std::atomic<int> nextFrame(0);
+    std::mutex emitMutex;
+    int nextToEmit = 0;
+
+    // ÿƬһߣȡڷƬڿ֡ (ֻ workspace һ֡)
+    cv::parallel_for_(cv::Range(0, workerCount), [&](const cv::Range& range) {
+        for (int worker = range.start; worker < range.end; ++worker) {
+            WatermarkExtractor extractor(expectedWatermarkLength, profile);
+            for (int i = nextFrame.fetch_add(1); i < frameCount; i = nextFrame.fetch_add(1)) {
+                KeyframeResult& result = results[i];
+                result.frameNumber = frameNumbers[i];
+                cv::Mat inputImage = cv::imread(framePaths[i], cv::IMREAD_COLOR);
+                if (!inputImage.empty()) {
+                    cv::Mat yuvInput;
+                    cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
+                    std::vector<cv::Mat> yuvChannels;
+                    cv::split(yuvInput, yuvChannels);
+                    try {
+                        result.text = extractor.extractWatermark(yuvChannels[0]);
+                    } catch (...) {
+                        result.text.clear();
+                    }
+                }
+                result.valid = !result.text.empty();
+                if (result.valid) {
+                    votes.add(result.text);
+                }
+
+                // ֡˳֮֡ǰ֡ɺͬѻĺ֡һ
+                std::lock_guard<std::mutex> lock(emitMutex);
+                finished[i] = 1;
+                while (nextToEmit < frameCount && finished[nextToEmit]) {
+                    onResult(results[nextToEmit]);
+                    ++nextToEmit;
+                }
+            }
+        }
+    }, workerCount);
+}
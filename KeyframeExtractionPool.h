@@ -0,0 +1,39 @@
+#ifndef KEYFRAME_EXTRACTION_POOL_H
+#define KEYFRAME_EXTRACTION_POOL_H
+
+#include "ShardedVoteTable.h"
+#include "WatermarkProfile.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// ؼ֡ȡ
+struct KeyframeResult {
+    int frameNumber = 0; // Ƶе֡ ()
+    bool valid = false; // ǷЧˮӡ
+    std::string text;
+};
+
+// ؼ֡ȡnumWorkers ߸һõ WatermarkExtractorӹȡһ֡
+// дƬƱÿ֡˳ص (ǰ֡δʱɵ֡Ȼ)
+// 쵽Щ֡ȡڵȣ˲֡ãÿ֡ͼ߳͵޹
+class KeyframeExtractionPool {
+public:
+    // numWorkers <= 0 ʱȡ cv::getNumThreads()
+    KeyframeExtractionPool(int expectedWatermarkLength, const WatermarkProfile& profile, int numWorkers = 0);
+
+    // framePaths[i] Ϊؼ֡ͼļframeNumbers[i] Ϊ֡ţonResult  i ˳򱻵 ()
+    void run(const std::vector<std::string>& framePaths, const std::vector<int>& frameNumbers,
+             const std::function<void(const KeyframeResult&)>& onResult);
+
+    const ShardedVoteTable& getVotes() const { return votes; }
+    int getWorkerCount() const { return workerCount; }
+
+private:
+    int expectedWatermarkLength;
+    WatermarkProfile profile;
+    int workerCount;
+    ShardedVoteTable votes;
+};
+
+#endif // KEYFRAME_EXTRACTION_POOL_H
@@ -0,0 +1,90 @@
+#include "KeyframeSelector.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+KeyframeSelector::KeyframeSelector(int minInterval, int maxInterval, double cutThreshold)
+    : minInterval(minInterval), maxInterval(maxInterval), cutThreshold(cutThreshold),
+      fadeThreshold(1.5), minContrast(12.0), minEdgeDensity(0.02) {
+    if (minInterval < 1 || maxInterval < minInterval) {
+        throw std::invalid_argument("KeyframeSelector: Intervals must satisfy 1 <= minInterval <= maxInterval.");
+    }
+}
+
+void KeyframeSelector::addFrame(const cv::Mat& smallLuma) {
+    if (smallLuma.empty() || smallLuma.type() != CV_8UC1) {
+        throw std::invalid_argument("KeyframeSelector: Frame must be a non-empty CV_8UC1 image.");
+    }
+    FrameActivity frame;
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(smallLuma, mean, stddev);
+    frame.meanLuma = mean[0];
+    frame.contrast = stddev[0];
+
+    cv::Canny(smallLuma, edgeBuffer, 50, 150);
+    frame.edgeDensity = static_cast<double>(cv::countNonZero(edgeBuffer)) / smallLuma.total();
+
+    if (previousLuma.empty() || previousLuma.size() != smallLuma.size()) {
+        frame.sceneCut = true;
+    } else {
+        frame.meanAbsDiff = cv::norm(smallLuma, previousLuma, cv::NORM_L1) / smallLuma.total();
+        frame.sceneCut = frame.meanAbsDiff > cutThreshold;
+    }
+    smallLuma.copyTo(previousLuma);
+    activity.push_back(frame);
+}
+
+bool KeyframeSelector::isEligible(int frameIndex) const {
+    const FrameActivity& frame = activity[frameIndex];
+    if (frame.contrast < minContrast || frame.edgeDensity < minEdgeDensity) {
+        return false;
+    }
+    // 䣺ȳ仯δﵽлֵǰ֡
+    if (frameIndex > 0 && !frame.sceneCut
+        && std::abs(frame.meanLuma - activity[frameIndex - 1].meanLuma) > fadeThreshold) {
+        return false;
+    }
+    if (frameIndex + 1 < static_cast<int>(activity.size()) && !activity[frameIndex + 1].sceneCut
+        && std::abs(activity[frameIndex + 1].meanLuma - frame.meanLuma) > fadeThreshold) {
+        return false;
+    }
+    return true;
+}
+
+std::vector<int> KeyframeSelector::selectKeyframes() const {
+    std::vector<int> keyframes;
+    const int frameCount = static_cast<int>(activity.size());
+    int shotStart = 0;
+    while (shotStart < frameCount) {
+        int shotEnd = shotStart + 1;
+        while (shotEnd < frameCount && !activity[shotEnd].sceneCut) {
+            ++shotEnd;
+        }
+
+        // ͷڰѡḻĺϸ֡ѡе k ֡һΪ [k + minInterval, k + maxInterval]
+        int windowStart = shotStart;
+        if (!keyframes.empty()) {
+            windowStart = std::max(windowStart, keyframes.back() + minInterval);
+        }
+        int windowEnd = std::min(shotEnd, windowStart + maxInterval);
+        while (windowStart < shotEnd) {
+            int best = -1;
+            for (int i = windowStart; i < windowEnd; ++i) {
+                if (isEligible(i) && (best < 0 || activity[i].edgeDensity > activity[best].edgeDensity)) {
+                    best = i;
+                }
+            }
+            if (best < 0) {
+                // ڶϸ (ƽ̹ / )
+                windowStart = windowEnd;
+                windowEnd = std::min(shotEnd, windowStart + maxInterval);
+                continue;
+            }
+            keyframes.push_back(best);
+            windowStart = best + minInterval;
+            windowEnd = std::min(shotEnd, best + maxInterval + 1);
+        }
+        shotStart = shotEnd;
+    }
+    return keyframes;
+}
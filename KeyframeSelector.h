@@ -0,0 +1,47 @@
+#ifndef KEYFRAME_SELECTOR_H
+#define KEYFRAME_SELECTOR_H
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// ֡ۻ (С Y ƽϼ)
+struct FrameActivity {
+    double meanAbsDiff = 0.0; // һ֡ƽȲ (ͷл)
+    double meanLuma = 0.0; // ƽ ()
+    double contrast = 0.0; // ȱ׼
+    double edgeDensity = 0.0; // Canny Եر (ḻ̶)
+    bool sceneCut = false; // ǷΪ¾ͷĵһ֡
+};
+
+// ֪Ƕ֡ѡ񣺱ܿƽ̹֡͵뵭֡ (Щ֡ selectEmbeddingRegions ֻѡ)
+// ÿͷѡḻ֡Ƕ֡ [minInterval, maxInterval]  (ͷ̻ȫϸʱ)
+// ÷֡ addFrame selectKeyframes õǶ֡ ( 0 ʼ֡)ñЩ֡ǿ I ֡
+class KeyframeSelector {
+public:
+    KeyframeSelector(int minInterval = 15, int maxInterval = 90, double cutThreshold = 25.0);
+
+    // һ֡С Y ƽ (CV_8UC1֡ߴһ)
+    void addFrame(const cv::Mat& smallLuma);
+
+    // ȫ֡ĶѡǶ֡
+    std::vector<int> selectKeyframes() const;
+
+    const std::vector<FrameActivity>& getActivity() const { return activity; }
+
+    // ֡ǷʺǶ룺㹻ͶԱȶȣҲȽ
+    bool isEligible(int frameIndex) const;
+
+private:
+    int minInterval;
+    int maxInterval;
+    double cutThreshold; // ƽԲֵΪͷл
+    double fadeThreshold; // л֡ƽȱ仯ֵΪ
+    double minContrast;
+    double minEdgeDensity;
+
+    std::vector<FrameActivity> activity;
+    cv::Mat previousLuma; // һ֡ (֡)
+    cv::Mat edgeBuffer; // Canny 
+};
+
+#endif // KEYFRAME_SELECTOR_H
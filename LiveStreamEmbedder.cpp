@@ -0,0 +1,100 @@
+#include "LiveStreamEmbedder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+LiveStreamEmbedder::LiveStreamEmbedder(int width, int height, const std::string& watermarkText, int period, double budgetMs, const WatermarkProfile& profile)
+    : embedder(profile), watermarkText(watermarkText), frameWidth(width), frameHeight(height),
+      embedPeriod(period), budgetMs(budgetMs), frameIndex(0), predictedMs(0.0), latencyHistogram(kLatencyBins, 0) {
+    if (width <= 0 || height <= 0 || width % 2 != 0 || height % 2 != 0) {
+        throw std::invalid_argument("Stream frame size must be positive and even (yuv420p).");
+    }
+    if (period <= 0 || budgetMs <= 0) {
+        throw std::invalid_argument("Embedding period and latency budget must be positive.");
+    }
+    if (watermarkText.empty()) {
+        throw std::invalid_argument("Watermark text cannot be empty.");
+    }
+    // BT.601 ޷ΧY' = 16 + 219 * Y / 255
+    for (int value = 0; value < 256; ++value) {
+        toFullRange[value] = cv::saturate_cast<uint8_t>((value - 16) * 255.0 / 219.0);
+        toLimitedRange[value] = cv::saturate_cast<uint8_t>(value * 219.0 / 255.0 + 16.0);
+    }
+    fullRangeLuma.create(height, width, CV_8UC1);
+}
+
+void LiveStreamEmbedder::embedFrame(uint8_t* yPlane) {
+    for (int y = 0; y < frameHeight; ++y) {
+        const uint8_t* limitedRow = yPlane + static_cast<size_t>(y) * frameWidth;
+        uint8_t* fullRow = fullRangeLuma.ptr<uint8_t>(y);
+        for (int x = 0; x < frameWidth; ++x) {
+            fullRow[x] = toFullRange[limitedRow[x]];
+        }
+    }
+
+    embedder.embedWatermarkInPlace(fullRangeLuma, watermarkText);
+
+    // ֻдر޸ĵأ16-235 ֵ֮ ( / ) 
+    for (int y = 0; y < frameHeight; ++y) {
+        uint8_t* limitedRow = yPlane + static_cast<size_t>(y) * frameWidth;
+        const uint8_t* fullRow = fullRangeLuma.ptr<uint8_t>(y);
+        for (int x = 0; x < frameWidth; ++x) {
+            if (fullRow[x] != toFullRange[limitedRow[x]]) {
+                limitedRow[x] = toLimitedRange[fullRow[x]];
+            }
+        }
+    }
+}
+
+void LiveStreamEmbedder::processFrame(uint8_t* frame) {
+    auto start = std::chrono::steady_clock::now();
+    if (frameIndex % embedPeriod == 0) {
+        if (predictedMs > budgetMs) {
+            // ԤⳬԤ㣺ڲǶ룬Ԥֵ˥ʹ½³
+            predictedMs *= 0.8;
+            ++stats.skipped;
+        } else {
+            try {
+                // Y ƽλ֡ͷ
+                embedFrame(frame);
+                ++stats.embedded;
+            } catch (const std::exception& e) {
+                // ֡ѡ (ڳ)ԭ
+                libraryWarning() << "Warning: Stream frame " << frameIndex << " not embedded: " << e.what() << std::endl;
+                ++stats.skipped;
+            }
+            double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            predictedMs = predictedMs == 0.0 ? elapsedMs : 0.8 * predictedMs + 0.2 * elapsedMs;
+        }
+    }
+
+    double latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    int bin = std::min(kLatencyBins - 1, static_cast<int>(latencyMs / kLatencyBinMs));
+    ++latencyHistogram[bin];
+    stats.maxMs = std::max(stats.maxMs, latencyMs);
+    ++stats.frames;
+    ++frameIndex;
+}
+
+double LiveStreamEmbedder::latencyPercentile(double fraction) const {
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * stats.frames)));
+    uint64_t cumulative = 0;
+    for (int bin = 0; bin < kLatencyBins; ++bin) {
+        cumulative += latencyHistogram[bin];
+        if (cumulative >= target) {
+            return std::min((bin + 1) * kLatencyBinMs, stats.maxMs);
+        }
+    }
+    return stats.maxMs;
+}
+
+LiveStreamStats LiveStreamEmbedder::getStats() const {
+    LiveStreamStats result = stats;
+    if (stats.frames > 0) {
+        result.p50Ms = latencyPercentile(0.5);
+        result.p99Ms = latencyPercentile(0.99);
+    }
+    return result;
+}
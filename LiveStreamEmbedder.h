@@ -0,0 +1,67 @@
+#ifndef LIVE_STREAM_EMBEDDER_H
+#define LIVE_STREAM_EMBEDDER_H
+
+#include "WatermarkEmbedder.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// ʵʱͳ
+struct LiveStreamStats {
+    int frames = 0; // ֡
+    int embedded = 0; // Ƕˮӡ֡
+    int skipped = 0; // Ԥ㲻ѡδǶĵ֡
+    double p50Ms = 0.0; // ÿ֡ӳٵλ (ӳֱͼõ 0.1 ms)
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+// ӳʵʱǶ룺֡ yuv420p ԭʼ֡ (ֻԭ޸ Y ƽ)֡Ϊ period ֡Ƕ롣
+// ѡʼȡͬͼ (ѡȡҲ)
+// ÿ֡ӳԤ㣺ǶʱָƽԤⱾκʱԤʱڡ֡ԭ
+// ҲƳٵ֡Ԥֵÿʱ˥½³ԡ
+// Ƕֻ֡ period ϣperiod Ϊ 30 ʱֱ video-extract (fixed) ȡ
+//  Y Ϊ޷Χ (16-235)ȡɽ BGR õȫΧ YǶչȫΧ
+// ϽУֻѱ޸ĵѹ޷Χд֡ (δ޸ĵֽڲ)
+class LiveStreamEmbedder {
+public:
+    LiveStreamEmbedder(int width, int height, const std::string& watermarkText, int period = 30, double budgetMs = 33.0,
+                       const WatermarkProfile& profile = WatermarkProfile());
+
+    // һ֡ yuv420p ֽ
+    size_t getFrameBytes() const { return static_cast<size_t>(frameWidth) * frameHeight * 3 / 2; }
+
+    // һ֡frame ָ getFrameBytes() ֽڵ yuv420p ݣҪǶʱԭ޸ Y ƽ
+    void processFrame(uint8_t* frame);
+
+    // ͳ (ӳٷλ)
+    LiveStreamStats getStats() const;
+
+private:
+    static const int kLatencyBins = 2000; // ӳֱͼĸ (һиӳ)
+    static constexpr double kLatencyBinMs = 0.1; // ÿ
+
+    WatermarkEmbedder embedder;
+    std::string watermarkText;
+    int frameWidth;
+    int frameHeight;
+    int embedPeriod;
+    double budgetMs;
+
+    int frameIndex;
+    double predictedMs; // ǶʱԤֵ (0 ʾ޲)
+    cv::Mat fullRangeLuma; // չȫΧ Y (֡)
+    uint8_t toFullRange[256]; // ޷Χ -> ȫΧ
+    uint8_t toLimitedRange[256]; // ȫΧ -> ޷Χ ( 16-235 ֵ toFullRange )
+    LiveStreamStats stats;
+    std::vector<uint32_t> latencyHistogram; // ÿ֡ӳٵĶֱͼ (ʱв)
+
+    // ȫΧǶ룬ֻдر޸ĵ
+    void embedFrame(uint8_t* yPlane);
+
+    // ӳֱͼķλ (ȡڸأֵ)
+    double latencyPercentile(double fraction) const;
+};
+
+#endif // LIVE_STREAM_EMBEDDER_H
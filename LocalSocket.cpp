@@ -0,0 +1,178 @@
+#include "LocalSocket.h"
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+typedef SOCKET NativeSocket;
+const int ShutdownBoth = SD_BOTH;
+
+// ֻʼһ Winsock
+void ensureSocketsInitialized() {
+    static bool initialized = []() {
+        WSADATA wsaData;
+        return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+    }();
+    if (!initialized) {
+        throw std::runtime_error("Could not initialize Winsock.");
+    }
+}
+
+void closeNative(NativeSocket s) { closesocket(s); }
+#else
+typedef int NativeSocket;
+const int ShutdownBoth = SHUT_RDWR;
+
+void ensureSocketsInitialized() {}
+
+void closeNative(NativeSocket s) { ::close(s); }
+#endif
+
+#ifdef MSG_NOSIGNAL
+const int SendFlags = MSG_NOSIGNAL; // ԶѹرʱشǴ SIGPIPE
+#else
+const int SendFlags = 0;
+#endif
+
+sockaddr_un makeAddress(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path is empty or too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return address;
+}
+
+NativeSocket toNative(intptr_t handle) { return static_cast<NativeSocket>(handle); }
+}
+
+LocalSocket::~LocalSocket() {
+    close();
+}
+
+LocalSocket::LocalSocket(LocalSocket&& other) noexcept
+    : handle(other.handle), readBuffer(std::move(other.readBuffer)) {
+    other.handle = -1;
+}
+
+LocalSocket& LocalSocket::operator=(LocalSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle = other.handle;
+        readBuffer = std::move(other.readBuffer);
+        other.handle = -1;
+    }
+    return *this;
+}
+
+LocalSocket LocalSocket::listen(const std::string& path, int backlog) {
+    ensureSocketsInitialized();
+    sockaddr_un address = makeAddress(path);
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored); // ϴ쳣˳׽ļ
+
+    NativeSocket s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    LocalSocket listener(static_cast<intptr_t>(s));
+    if (listener.handle == -1) {
+        throw std::runtime_error("Could not create socket.");
+    }
+    if (::bind(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("Could not bind socket to " + path);
+    }
+#ifndef _WIN32
+    // ׽ļֻд (ҪдȨ) listen ֮ǰսɱûӵĴ
+    if (::chmod(path.c_str(), S_IRUSR | S_IWUSR) != 0) {
+        throw std::runtime_error("Could not restrict permissions of " + path);
+    }
+#endif
+    if (::listen(s, backlog) != 0) {
+        throw std::runtime_error("Could not listen on " + path);
+    }
+    return listener;
+}
+
+LocalSocket LocalSocket::connect(const std::string& path) {
+    ensureSocketsInitialized();
+    sockaddr_un address = makeAddress(path);
+    NativeSocket s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    LocalSocket client(static_cast<intptr_t>(s));
+    if (client.handle == -1) {
+        throw std::runtime_error("Could not create socket.");
+    }
+    if (::connect(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("Could not connect to " + path);
+    }
+    return client;
+}
+
+LocalSocket LocalSocket::accept() {
+    if (handle == -1) {
+        return LocalSocket();
+    }
+    NativeSocket s = ::accept(toNative(handle), nullptr, nullptr);
+    return LocalSocket(static_cast<intptr_t>(s));
+}
+
+bool LocalSocket::readLine(std::string& line) {
+    while (true) {
+        size_t newline = readBuffer.find('\n');
+        if (newline != std::string::npos) {
+            line.assign(readBuffer, 0, newline);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            readBuffer.erase(0, newline + 1);
+            return true;
+        }
+        if (handle == -1) {
+            return false;
+        }
+        char chunk[4096];
+        int received = static_cast<int>(::recv(toNative(handle), chunk, sizeof(chunk), 0));
+        if (received <= 0) {
+            return false;
+        }
+        readBuffer.append(chunk, received);
+    }
+}
+
+bool LocalSocket::writeLine(const std::string& line) {
+    if (handle == -1) {
+        return false;
+    }
+    std::string data = line + "\n";
+    size_t sent = 0;
+    while (sent < data.size()) {
+        int count = static_cast<int>(::send(toNative(handle), data.data() + sent, static_cast<int>(data.size() - sent), SendFlags));
+        if (count <= 0) {
+            return false;
+        }
+        sent += count;
+    }
+    return true;
+}
+
+void LocalSocket::shutdown() {
+    if (handle != -1) {
+        ::shutdown(toNative(handle), ShutdownBoth);
+    }
+}
+
+void LocalSocket::close() {
+    if (handle != -1) {
+        closeNative(toNative(handle));
+        handle = -1;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef LOCAL_SOCKET_H
+#define LOCAL_SOCKET_H
+
+#include <cstdint>
+#include <string>
+
+// Unix ׽ (Windows 10  AF_UNIX ͬ) Сװշı
+// ֻƶɸƣʱر
+class LocalSocket {
+public:
+    LocalSocket() : handle(-1) {}
+    ~LocalSocket();
+    LocalSocket(LocalSocket&& other) noexcept;
+    LocalSocket& operator=(LocalSocket&& other) noexcept;
+    LocalSocket(const LocalSocket&) = delete;
+    LocalSocket& operator=(const LocalSocket&) = delete;
+
+    //  path ϼ (ɾ׽ļ)POSIX ׽ļȨΪ 0600ֻͬһûӡ
+    // ʧ׳ std::runtime_error
+    static LocalSocket listen(const std::string& path, int backlog = 64);
+    // ӵ path ϼķʧ׳ std::runtime_error
+    static LocalSocket connect(const std::string& path);
+
+    // ȴӣ׽ֱرպ󷵻Ч׽
+    LocalSocket accept();
+
+    // һ (з)ӹرջʱ false
+    bool readLine(std::string& line);
+    // дһ (Զ׷ӻз)ʧܷ false
+    bool writeLine(const std::string& line);
+
+    bool isValid() const { return handle != -1; }
+    // رնдˣ accept / readLine ϵ߳漴
+    void shutdown();
+    void close();
+
+private:
+    intptr_t handle; // ƽ̨׽־ (POSIX fd / Windows SOCKET)
+    std::string readBuffer; // յδȡߵ
+
+    explicit LocalSocket(intptr_t handle) : handle(handle) {}
+};
+
+#endif // LOCAL_SOCKET_H
@@ -0,0 +1,121 @@
+#include "MultiHypothesisExtractor.h"
+#include "EdgeDetector.h"
+#include "WatermarkExtractor.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+MultiHypothesisExtractor::MultiHypothesisExtractor(int expectedWatermarkLength, const WatermarkProfile& baseProfile)
+    : expectedWatermarkLength(expectedWatermarkLength), baseProfile(baseProfile) {
+    if (expectedWatermarkLength <= 0) {
+        throw std::invalid_argument("Expected watermark length must be positive.");
+    }
+}
+
+void MultiHypothesisExtractor::addHypothesis(const ExtractionHypothesis& hypothesis) {
+    if (hypothesis.imageScale <= 0) {
+        throw std::invalid_argument("Hypothesis image scale must be positive.");
+    }
+    hypotheses.push_back(hypothesis);
+}
+
+void MultiHypothesisExtractor::addGrid(const std::vector<int>& edgeThresholds, const std::vector<double>& windowScales,
+                                       const std::vector<double>& stepScales, const std::vector<double>& imageScales) {
+    for (double imageScale : imageScales) {
+        for (double windowScale : windowScales) {
+            for (double stepScale : stepScales) {
+                for (int edgeThreshold : edgeThresholds) {
+                    ExtractionHypothesis hypothesis;
+                    hypothesis.edgeThreshold = edgeThreshold;
+                    hypothesis.windowScale = windowScale;
+                    hypothesis.stepScale = stepScale;
+                    hypothesis.imageScale = imageScale;
+                    addHypothesis(hypothesis);
+                }
+            }
+        }
+    }
+}
+
+HypothesisResult MultiHypothesisExtractor::extract(const cv::Mat& image) {
+    if (image.empty() || image.channels() != 1) {
+        throw std::invalid_argument("Input image must be a non-empty single channel image.");
+    }
+    HypothesisResult result;
+    if (hypotheses.empty()) {
+        return result;
+    }
+
+    // 1. ű飬ÿֻһźͱԵ
+    std::vector<ScaledInput> inputs;
+    std::vector<int> inputOfHypothesis(hypotheses.size());
+    for (size_t h = 0; h < hypotheses.size(); ++h) {
+        size_t idx = 0;
+        while (idx < inputs.size() && inputs[idx].imageScale != hypotheses[h].imageScale) {
+            ++idx;
+        }
+        if (idx == inputs.size()) {
+            ScaledInput input;
+            input.imageScale = hypotheses[h].imageScale;
+            inputs.push_back(input);
+        }
+        inputOfHypothesis[h] = static_cast<int>(idx);
+    }
+
+    cv::parallel_for_(cv::Range(0, static_cast<int>(inputs.size())), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) {
+            ScaledInput& input = inputs[i];
+            if (input.imageScale == 1.0) {
+                input.image = image;
+            } else {
+                int interpolation = input.imageScale < 1.0 ? cv::INTER_AREA : cv::INTER_LINEAR;
+                cv::resize(image, input.image, cv::Size(), input.imageScale, input.imageScale, interpolation);
+            }
+            FrameWorkspace workspace;
+            EdgeDetector edgeDetector(baseProfile.cannyLow, baseProfile.cannyHigh, baseProfile.postProcessThreshold);
+            input.edges = edgeDetector.detectEdgeBitmap(input.image, workspace);
+        }
+    });
+
+    // 2. ÿһ񣻳ɹλȡ־δʼֱӷأеڽ׶α߽紦
+    std::atomic<bool> cancelled(false);
+    std::mutex resultMutex;
+    const int hypothesisCount = static_cast<int>(hypotheses.size());
+    cv::parallel_for_(cv::Range(0, hypothesisCount), [&](const cv::Range& range) {
+        for (int h = range.start; h < range.end; ++h) {
+            if (cancelled.load(std::memory_order_relaxed)) {
+                return;
+            }
+            const ExtractionHypothesis& hypothesis = hypotheses[h];
+            const ScaledInput& input = inputs[inputOfHypothesis[h]];
+            std::string text;
+            try {
+                ScopedLibraryLogMute mute; // ֻرձ߳ڸüڵ־
+                WatermarkProfile profile = baseProfile;
+                profile.edgeThreshold = hypothesis.edgeThreshold;
+                profile.windowScale = hypothesis.windowScale;
+                profile.stepScale = hypothesis.stepScale;
+                WatermarkExtractor extractor(expectedWatermarkLength, profile);
+                extractor.setCancellationFlag(&cancelled);
+                if (!extractor.tryExtractWithEdges(input.image, input.edges, text)) {
+                    continue;
+                }
+            } catch (const std::exception& e) {
+                libraryWarning() << "Warning: Hypothesis " << h << " failed: " << e.what() << std::endl;
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (!result.found) {
+                result.found = true;
+                result.text = text;
+                result.hypothesis = hypothesis;
+                result.hypothesisIndex = h;
+                cancelled.store(true, std::memory_order_relaxed);
+            }
+        }
+    }, hypothesisCount); // ÿһƬ߳̿к󼴿ȡһ
+
+    return result;
+}
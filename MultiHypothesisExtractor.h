@@ -0,0 +1,59 @@
+#ifndef MULTI_HYPOTHESIS_EXTRACTOR_H
+#define MULTI_HYPOTHESIS_EXTRACTOR_H
+
+#include "EdgeBitmap.h"
+#include "WatermarkProfile.h"
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// һȡ
+struct ExtractionHypothesis {
+    int edgeThreshold = 5; // Եֵ Th
+    double windowScale = 0.25; // ѡ񻬴
+    double stepScale = 0.25; // ѡ񲽳
+    double imageScale = 1.0; // ȡǰ Y ͨű (ǶŹͼ)
+};
+
+// ȡ
+struct HypothesisResult {
+    bool found = false;
+    std::string text; // ˮӡ
+    ExtractionHypothesis hypothesis; // ɹļ
+    int hypothesisIndex = -1; // ɹļ
+};
+
+// 貢ȡ̳߳ͬʱԶһͨλ RS ȡ衣
+// ͬһűļ蹲ź Y ͨͱԵͼ (Եֻͼйأ Th޹)
+// 谴˳ţͬʱɹʱȵǼǳɹǸ
+// ȡУ־໥ڼڲرգ (ɹļ) ɵ÷
+class MultiHypothesisExtractor {
+public:
+    // ֻ Thű (Canny / ֵ˹) ȡ baseProfile
+    explicit MultiHypothesisExtractor(int expectedWatermarkLength = 361, const WatermarkProfile& baseProfile = WatermarkProfile());
+
+    void addHypothesis(const ExtractionHypothesis& hypothesis);
+
+    // ȡֵĵѿ (ĬϲڸбĵһԱȵ)
+    void addGrid(const std::vector<int>& edgeThresholds, const std::vector<double>& windowScales,
+                 const std::vector<double>& stepScales, const std::vector<double>& imageScales);
+
+    const std::vector<ExtractionHypothesis>& getHypotheses() const { return hypotheses; }
+
+    //  Y ͨ (CV_8U) ִжȡ
+    HypothesisResult extract(const cv::Mat& image);
+
+private:
+    int expectedWatermarkLength;
+    WatermarkProfile baseProfile;
+    std::vector<ExtractionHypothesis> hypotheses;
+
+    // ÿű
+    struct ScaledInput {
+        double imageScale;
+        cv::Mat image;
+        EdgeBitmap edges;
+    };
+};
+
+#endif // MULTI_HYPOTHESIS_EXTRACTOR_H
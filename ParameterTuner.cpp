@@ -0,0 +1,121 @@
+#include "ParameterTuner.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+// һάռ䣺ѡֵѺѡֵдõĺ
+struct TuningDimension {
+    const char* name;
+    int valueCount;
+    std::function<void(WatermarkProfile&, int)> apply;
+};
+
+std::vector<TuningDimension> makeDimensions() {
+    static const double windowScales[] = { 0.15, 0.2, 0.25, 0.3 };
+    static const double stepScales[] = { 0.25, 0.5, 0.75 };
+    static const int edgeThresholds[] = { 3, 5, 10, 25 };
+    static const double gaussianSigmas[] = { 1.0, 1.5, 2.5 };
+    static const double cannyThresholds[][2] = { { 30, 100 }, { 50, 150 }, { 80, 200 } };
+    static const double postProcessThresholds[] = { 15, 30, 45 };
+    return {
+        { "window_scale", 4, [](WatermarkProfile& p, int i) { p.windowScale = windowScales[i]; } },
+        { "step_scale", 3, [](WatermarkProfile& p, int i) { p.stepScale = stepScales[i]; } },
+        { "edge_threshold", 4, [](WatermarkProfile& p, int i) { p.edgeThreshold = edgeThresholds[i]; } },
+        { "gaussian_sigma", 3, [](WatermarkProfile& p, int i) { p.gaussianSigma = gaussianSigmas[i]; } },
+        { "canny", 3, [](WatermarkProfile& p, int i) { p.cannyLow = cannyThresholds[i][0]; p.cannyHigh = cannyThresholds[i][1]; } },
+        { "post_process_threshold", 3, [](WatermarkProfile& p, int i) { p.postProcessThreshold = postProcessThresholds[i]; } }
+    };
+}
+}
+
+ParameterTuner::ParameterTuner(RobustnessBenchmark& benchmark, const std::vector<AttackChain>& chains, double targetSuccessRate)
+    : benchmark(benchmark), chains(chains), targetSuccessRate(targetSuccessRate), progress(nullptr) {
+}
+
+bool ParameterTuner::isBetter(const TuningCandidate& a, const TuningCandidate& b) const {
+    if (a.meetsTarget != b.meetsTarget) {
+        return a.meetsTarget;
+    }
+    if (a.meetsTarget) {
+        // ѡڲͬʱ̲ãҪٿ 3% 滻л
+        return a.processingMs < b.processingMs * 0.97;
+    }
+    if (a.successRate != b.successRate) {
+        return a.successRate > b.successRate;
+    }
+    return a.processingMs < b.processingMs;
+}
+
+std::vector<TuningCandidate> ParameterTuner::evaluate(const std::vector<WatermarkProfile>& profiles) {
+    std::vector<BenchmarkConfiguration> pending;
+    for (const WatermarkProfile& profile : profiles) {
+        std::string key = profile.describe();
+        bool queued = std::any_of(pending.begin(), pending.end(), [&](const BenchmarkConfiguration& c) { return c.profile.describe() == key; });
+        if (evaluated.count(key) == 0 && !queued) {
+            BenchmarkConfiguration configuration;
+            configuration.profile = profile;
+            pending.push_back(configuration);
+        }
+    }
+
+    if (!pending.empty()) {
+        // ѡʱʱúģõĺʱȡͬѡǲ
+        std::vector<BenchmarkRow> rows = benchmark.run(pending, chains, false);
+        size_t chainCount = chains.size();
+        for (size_t k = 0; k < pending.size(); ++k) {
+            TuningCandidate candidate;
+            candidate.profile = pending[k].profile;
+            candidate.successRate = 1.0;
+            for (size_t c = 0; c < chainCount; ++c) {
+                const BenchmarkRow& row = rows[k * chainCount + c];
+                // δǶͼΪʧ
+                int attempted = row.images + row.embedFailures;
+                double successRate = attempted > 0 ? static_cast<double>(row.decoded) / attempted : 0.0;
+                candidate.successRate = std::min(candidate.successRate, successRate);
+                candidate.processingMs += (row.embedMs + row.extractMs + row.decodeMs) / chainCount;
+            }
+            candidate.meetsTarget = candidate.successRate >= targetSuccessRate;
+            evaluated[candidate.profile.describe()] = candidate;
+            if (progress != nullptr) {
+                *progress << "  " << candidate.profile.describe() << ": success " << candidate.successRate * 100.0 << "%, "
+                          << candidate.processingMs << " ms/image" << (candidate.meetsTarget ? "" : " (below target)") << std::endl;
+            }
+        }
+    }
+
+    std::vector<TuningCandidate> results;
+    for (const WatermarkProfile& profile : profiles) {
+        results.push_back(evaluated[profile.describe()]);
+    }
+    return results;
+}
+
+TuningCandidate ParameterTuner::tune(const WatermarkProfile& start, int maxRounds) {
+    std::vector<TuningDimension> dimensions = makeDimensions();
+    TuningCandidate best = evaluate({ start })[0];
+
+    for (int round = 0; round < maxRounds; ++round) {
+        bool changed = false;
+        for (const TuningDimension& dimension : dimensions) {
+            if (progress != nullptr) {
+                *progress << "Round " << round + 1 << ", " << dimension.name << ":" << std::endl;
+            }
+            std::vector<WatermarkProfile> profiles;
+            for (int i = 0; i < dimension.valueCount; ++i) {
+                WatermarkProfile profile = best.profile;
+                dimension.apply(profile, i);
+                profiles.push_back(profile);
+            }
+            for (const TuningCandidate& candidate : evaluate(profiles)) {
+                if (isBetter(candidate, best)) {
+                    best = candidate;
+                    changed = true;
+                }
+            }
+        }
+        if (!changed) {
+            break;
+        }
+    }
+    return best;
+}
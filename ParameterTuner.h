@@ -0,0 +1,48 @@
+#ifndef PARAMETER_TUNER_H
+#define PARAMETER_TUNER_H
+
+#include "RobustnessBenchmark.h"
+#include "WatermarkProfile.h"
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// һ
+struct TuningCandidate {
+    WatermarkProfile profile;
+    double successRate = 0.0; // ͵Ľɹ
+    double processingMs = 0.0; // ÿͼǶ + ȡ + ʱ (ƽ)
+    bool meetsTarget = false;
+};
+
+// Զţͼָ£ѰĿɹʵ
+// ʽΪ½ÿζÿһάȫѡֵ (ά̶ѡл׼ʱѡúӰ)
+// Ŀʱȡߣʱȡɹߣһûκθıﵽʱϲظ
+class ParameterTuner {
+public:
+    ParameterTuner(RobustnessBenchmark& benchmark, const std::vector<AttackChain>& chains, double targetSuccessRate);
+
+    //  (nullptr ʾ)
+    void setProgressStream(std::ostream* stream) { progress = stream; }
+
+    //  start ʼѡе
+    TuningCandidate tune(const WatermarkProfile& start = WatermarkProfile(), int maxRounds = 3);
+
+    int getEvaluationCount() const { return static_cast<int>(evaluated.size()); }
+
+private:
+    RobustnessBenchmark& benchmark;
+    std::vector<AttackChain> chains;
+    double targetSuccessRate;
+    std::ostream* progress;
+    std::map<std::string, TuningCandidate> evaluated; //  profile.describe() Ϊ
+
+    // δϣ profiles һһӦĽ
+    std::vector<TuningCandidate> evaluate(const std::vector<WatermarkProfile>& profiles);
+
+    // a Ƿ b
+    bool isBetter(const TuningCandidate& a, const TuningCandidate& b) const;
+};
+
+#endif // PARAMETER_TUNER_H
@@ -7,6 +7,11 @@ RegionScorer::RegionScorer(double alpha, double beta, double gamma, double delta
 
 // е÷ֲ Region 
 void RegionScorer::calculateRegionScores(Region& region, const cv::Mat& originalPatch, const cv::Mat& edgePatch, const cv::Point& imageCenter) {
+    FrameWorkspace workspace;
+    calculateRegionScores(region, originalPatch, edgePatch, imageCenter, workspace);
+}
+
+void RegionScorer::calculateRegionScores(Region& region, const cv::Mat& originalPatch, const cv::Mat& edgePatch, const cv::Point& imageCenter, FrameWorkspace& workspace) {
     if (originalPatch.empty() || edgePatch.empty() || originalPatch.size() != edgePatch.size()) {
          throw std::runtime_error("RegionScorer: Input patches are invalid or mismatched.");
     }
@@ -15,7 +20,23 @@ void RegionScorer::calculateRegionScores(Region& region, const cv::Mat& original
     }
 
     region.edgeScore = calculateEdgeScore(edgePatch);
-    region.textureScore = calculateTextureScore(originalPatch);
+    region.textureScore = calculateTextureScore(originalPatch, workspace);
+    region.grayScore = calculateGrayScore(originalPatch);
+    region.positionScore = calculatePositionScore(region.center, imageCenter, region.bounds.width, region.bounds.height);
+
+    region.score = calculateCombinedScore(region.edgeScore, region.textureScore, region.grayScore, region.positionScore);
+}
+
+void RegionScorer::calculateRegionScores(Region& region, const cv::Mat& originalPatch, const EdgeBitmap& edgeBitmap, const cv::Point& imageCenter, FrameWorkspace& workspace) {
+    if (originalPatch.empty() || originalPatch.size() != region.bounds.size()) {
+         throw std::runtime_error("RegionScorer: Input patches are invalid or mismatched.");
+    }
+    if (originalPatch.channels() != 1) {
+        throw std::runtime_error("RegionScorer: Patches must be single-channel grayscale.");
+    }
+
+    region.edgeScore = calculateEdgeScore(edgeBitmap, region.bounds);
+    region.textureScore = calculateTextureScore(originalPatch, workspace);
     region.grayScore = calculateGrayScore(originalPatch);
     region.positionScore = calculatePositionScore(region.center, imageCenter, region.bounds.width, region.bounds.height);
 
@@ -40,13 +61,27 @@ double RegionScorer::calculateEdgeScore(const cv::Mat& edgePatch) {
     return score;
 }
 
+double RegionScorer::calculateEdgeScore(const EdgeBitmap& edgeBitmap, const cv::Rect& bounds) {
+    if (bounds.width == 0 || bounds.height == 0) return 0.0;
+
+    //  popcount ͳƴڵıԵ
+    int edgePixelCount = edgeBitmap.countRect(bounds);
+    double denominator = static_cast<double>(edgePixelCount) + 1.0;
+    return std::sqrt(static_cast<double>(bounds.width * bounds.height) / denominator);
+}
+
 // ÷ H_uv (ʽ 3) - Ż汾ֲΪӶȲָ
 double RegionScorer::calculateTextureScore(const cv::Mat& originalPatch) {
+    FrameWorkspace workspace;
+    return calculateTextureScore(originalPatch, workspace);
+}
+
+double RegionScorer::calculateTextureScore(const cv::Mat& originalPatch, FrameWorkspace& workspace) {
     // 1. ԭʼֵ
     double entropy = calculateEntropy(originalPatch);
     
     // 2. ֲΪӶȵĲָ
-    cv::Mat floatPatch;
+    cv::Mat& floatPatch = workspace.buffer(FrameWorkspace::RegionFloatPatch, originalPatch.rows, originalPatch.cols, CV_32F);
     originalPatch.convertTo(floatPatch, CV_32F);
     
     // ֵ
@@ -54,8 +89,9 @@ double RegionScorer::calculateTextureScore(const cv::Mat& originalPatch) {
     double mean = meanVal[0];
     
     // 㷽
-    cv::Mat diffSquared;
-    cv::pow(floatPatch - mean, 2, diffSquared);
+    cv::Mat& diffSquared = workspace.buffer(FrameWorkspace::RegionDiffSquared, originalPatch.rows, originalPatch.cols, CV_32F);
+    cv::subtract(floatPatch, cv::Scalar(mean), diffSquared);
+    cv::pow(diffSquared, 2, diffSquared);
     cv::Scalar varianceScalar = cv::mean(diffSquared);
     double variance = varianceScalar[0];
     
@@ -2,6 +2,7 @@
 #define REGION_SCORER_H
 
 #include "utils.h"
+#include "FrameWorkspace.h"
 #include <opencv2/opencv.hpp>
 
 class RegionScorer {
@@ -11,12 +12,18 @@ public:
 
     // 㵥ۺϵ÷ (Ӧ Step 2 ּ)
     void calculateRegionScores(Region& region, const cv::Mat& originalPatch, const cv::Mat& edgePatch, const cv::Point& imageCenter);
+    void calculateRegionScores(Region& region, const cv::Mat& originalPatch, const cv::Mat& edgePatch, const cv::Point& imageCenter, FrameWorkspace& workspace);
+
+    // ͬϣԵ÷ֱڰλѹͼԵͼϰ region.bounds 
+    void calculateRegionScores(Region& region, const cv::Mat& originalPatch, const EdgeBitmap& edgeBitmap, const cv::Point& imageCenter, FrameWorkspace& workspace);
 
     // Ե÷ E_uv (ʽ 2)
     double calculateEdgeScore(const cv::Mat& edgePatch);
+    double calculateEdgeScore(const EdgeBitmap& edgeBitmap, const cv::Rect& bounds);
 
     // ÷ H_uv (ʽ 3) - ʹϢ
     double calculateTextureScore(const cv::Mat& originalPatch);
+    double calculateTextureScore(const cv::Mat& originalPatch, FrameWorkspace& workspace);
 
     // Ҷȵ÷ G_uv (ʽ 4)
     double calculateGrayScore(const cv::Mat& originalPatch);
@@ -12,6 +12,13 @@ RegionSelector::RegionSelector(RegionScorer scorer, int numRegionsToSelect, doub
 }
 
 std::vector<Region> RegionSelector::selectEmbeddingRegions(const cv::Mat& originalImage, const cv::Mat& edgeImage) {
+    FrameWorkspace workspace;
+    std::vector<Region> selectedRegions;
+    selectEmbeddingRegions(originalImage, edgeImage, workspace, selectedRegions);
+    return selectedRegions;
+}
+
+void RegionSelector::selectEmbeddingRegions(const cv::Mat& originalImage, const cv::Mat& edgeImage, FrameWorkspace& workspace, std::vector<Region>& selectedRegions) {
     if (originalImage.empty() || edgeImage.empty() || originalImage.size() != edgeImage.size()) {
         throw std::runtime_error("RegionSelector: Input images are invalid or mismatched.");
     }
@@ -19,6 +26,19 @@ std::vector<Region> RegionSelector::selectEmbeddingRegions(const cv::Mat& origin
         throw std::runtime_error("RegionSelector: Images must be single-channel grayscale.");
     }
 
+    EdgeBitmap& edgeBitmap = workspace.edgeBitmap();
+    edgeBitmap.fromMat(edgeImage);
+    selectEmbeddingRegions(originalImage, edgeBitmap, workspace, selectedRegions);
+}
+
+void RegionSelector::selectEmbeddingRegions(const cv::Mat& originalImage, const EdgeBitmap& edgeBitmap, FrameWorkspace& workspace, std::vector<Region>& selectedRegions) {
+    if (originalImage.empty() || edgeBitmap.empty() || originalImage.size() != edgeBitmap.size()) {
+        throw std::runtime_error("RegionSelector: Input images are invalid or mismatched.");
+    }
+    if (originalImage.channels() != 1) {
+        throw std::runtime_error("RegionSelector: Images must be single-channel grayscale.");
+    }
+
     int imgHeight = originalImage.rows;
     int imgWidth = originalImage.cols;
     cv::Point imageCenter(imgWidth / 2, imgHeight / 2);
@@ -31,7 +51,8 @@ std::vector<Region> RegionSelector::selectEmbeddingRegions(const cv::Mat& origin
     int stepY = std::max(1, static_cast<int>(windowHeight * stepSizeScale));
     int stepX = std::max(1, static_cast<int>(windowWidth * stepSizeScale));
 
-    std::vector<Region> candidateRegions;
+    std::vector<Region>& candidateRegions = workspace.candidateRegions();
+    candidateRegions.clear();
 
     // ڱ
     for (int y = 0; y <= imgHeight - windowHeight; y += stepY) {
@@ -40,28 +61,96 @@ std::vector<Region> RegionSelector::selectEmbeddingRegions(const cv::Mat& origin
             currentRegion.bounds = cv::Rect(x, y, windowWidth, windowHeight);
             currentRegion.center = cv::Point(x + windowWidth / 2, y + windowHeight / 2);
 
-            // ȡǰڶӦͼ
+            // ȡǰڶӦͼ (Եֱͼλͼϰڽ)
             cv::Mat originalPatch = originalImage(currentRegion.bounds);
-            cv::Mat edgePatch = edgeImage(currentRegion.bounds);
 
             // ÷
             try {
-                 regionScorer.calculateRegionScores(currentRegion, originalPatch, edgePatch, imageCenter);
+                 regionScorer.calculateRegionScores(currentRegion, originalPatch, edgeBitmap, imageCenter, workspace);
                  candidateRegions.push_back(currentRegion);
             } catch (const std::exception& e) {
                 // Լ¼־ԼʧܵĴ
-                 std::cerr << "Warning: Failed to score region at (" << x << "," << y << "): " << e.what() << std::endl;
+                 libraryWarning() << "Warning: Failed to score region at (" << x << "," << y << "): " << e.what() << std::endl;
             }
         }
     }
 
+    pickTopRegions(candidateRegions, selectedRegions);
+}
+
+void RegionSelector::refineEmbeddingRegions(const cv::Mat& originalImage, const EdgeBitmap& edgeBitmap, FrameWorkspace& workspace,
+                                            const std::vector<Region>& previousRegions, int searchSteps, std::vector<Region>& selectedRegions) {
+    if (originalImage.empty() || edgeBitmap.empty() || originalImage.size() != edgeBitmap.size()) {
+        throw std::runtime_error("RegionSelector: Input images are invalid or mismatched.");
+    }
+    if (originalImage.channels() != 1) {
+        throw std::runtime_error("RegionSelector: Images must be single-channel grayscale.");
+    }
+    if (&previousRegions == &selectedRegions) {
+        throw std::invalid_argument("RegionSelector: Previous and selected regions must be different containers.");
+    }
+
+    int imgHeight = originalImage.rows;
+    int imgWidth = originalImage.cols;
+    cv::Point imageCenter(imgWidth / 2, imgHeight / 2);
+    int windowHeight = std::max(1, static_cast<int>(imgHeight * windowSizeScale));
+    int windowWidth = std::max(1, static_cast<int>(imgWidth * windowSizeScale));
+    int stepY = std::max(1, static_cast<int>(windowHeight * stepSizeScale));
+    int stepX = std::max(1, static_cast<int>(windowWidth * stepSizeScale));
+
+    std::vector<Region>& candidateRegions = workspace.candidateRegions();
+    candidateRegions.clear();
+
+    // ѡΪһ֡ΧͼɨϵĴ (ͼɨĺѡͬһλõӼ)
+    for (const Region& previous : previousRegions) {
+        if (previous.bounds.width != windowWidth || previous.bounds.height != windowHeight) {
+            continue;
+        }
+        for (int dy = -searchSteps; dy <= searchSteps; ++dy) {
+            for (int dx = -searchSteps; dx <= searchSteps; ++dx) {
+                int x = previous.bounds.x + dx * stepX;
+                int y = previous.bounds.y + dy * stepY;
+                if (x < 0 || y < 0 || x > imgWidth - windowWidth || y > imgHeight - windowHeight) {
+                    continue;
+                }
+                bool duplicate = false;
+                for (const Region& candidate : candidateRegions) {
+                    if (candidate.bounds.x == x && candidate.bounds.y == y) {
+                        duplicate = true;
+                        break;
+                    }
+                }
+                if (duplicate) {
+                    continue;
+                }
+
+                Region currentRegion;
+                currentRegion.bounds = cv::Rect(x, y, windowWidth, windowHeight);
+                currentRegion.center = cv::Point(x + windowWidth / 2, y + windowHeight / 2);
+                try {
+                     regionScorer.calculateRegionScores(currentRegion, originalImage(currentRegion.bounds), edgeBitmap, imageCenter, workspace);
+                     candidateRegions.push_back(currentRegion);
+                } catch (const std::exception& e) {
+                     libraryWarning() << "Warning: Failed to score region at (" << x << "," << y << "): " << e.what() << std::endl;
+                }
+            }
+        }
+    }
+
+    pickTopRegions(candidateRegions, selectedRegions);
+}
+
+void RegionSelector::pickTopRegions(std::vector<Region>& candidateRegions, std::vector<Region>& selectedRegions) {
     // ۺϵ÷ִӸߵ
-    std::stable_sort(candidateRegions.begin(), candidateRegions.end(), [](const Region& a, const Region& b) {
-        return a.score > b.score; // 
+    // ѡɨ˳ (к) ɣͬʱɨ˳У stable_sort һʱ
+    std::sort(candidateRegions.begin(), candidateRegions.end(), [](const Region& a, const Region& b) {
+        if (a.score != b.score) return a.score > b.score; // 
+        if (a.bounds.y != b.bounds.y) return a.bounds.y < b.bounds.y;
+        return a.bounds.x < b.bounds.x;
     });
 
     // ѡǰ d ص
-    std::vector<Region> selectedRegions;
+    selectedRegions.clear();
     for (const auto& candidate : candidateRegions) {
         if (selectedRegions.size() >= targetRegionCount) {
             break; // ѡ
@@ -94,11 +183,8 @@ std::vector<Region> RegionSelector::selectEmbeddingRegions(const cv::Mat& origin
      if (selectedRegions.empty() && !candidateRegions.empty()) {
          // ϸصѡٷص÷ߵǸ
          selectedRegions.push_back(candidateRegions[0]);
-         std::cerr << "Warning: Could not find enough non-overlapping regions. Returning the highest scoring one(s)." << std::endl;
+         libraryWarning() << "Warning: Could not find enough non-overlapping regions. Returning the highest scoring one(s)." << std::endl;
      } else if (selectedRegions.size() < targetRegionCount) {
-         std::cerr << "Warning: Found only " << selectedRegions.size() << " non-overlapping regions (target was " << targetRegionCount << ")." << std::endl;
+         libraryWarning() << "Warning: Found only " << selectedRegions.size() << " non-overlapping regions (target was " << targetRegionCount << ")." << std::endl;
      }
-
-
-    return selectedRegions;
 }
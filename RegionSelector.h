@@ -3,6 +3,7 @@
 
 #include "utils.h"
 #include "RegionScorer.h"
+#include "FrameWorkspace.h"
 #include <vector>
 #include <opencv2/opencv.hpp>
 
@@ -14,6 +15,17 @@ public:
     // ѡǶ (Ӧ Step 2 Ҫ߼)
     std::vector<Region> selectEmbeddingRegions(const cv::Mat& originalImage, const cv::Mat& edgeImage);
 
+    // ͬϣѡбʹʱ workspaceд selectedRegions
+    void selectEmbeddingRegions(const cv::Mat& originalImage, const cv::Mat& edgeImage, FrameWorkspace& workspace, std::vector<Region>& selectedRegions);
+
+    // ͬϣԵͼΪλѹʽ (EdgeDetector::detectEdgeBitmap )
+    void selectEmbeddingRegions(const cv::Mat& originalImage, const EdgeBitmap& edgeBitmap, FrameWorkspace& workspace, std::vector<Region>& selectedRegions);
+
+    // ֲϸֻ previousRegions Χ searchSteps ڵĻλֲѡ
+    // (һ֡ͬһֹͷƵ֡ͼɨ)previousRegions ͬߴͼҲ selectedRegions ͬһ
+    void refineEmbeddingRegions(const cv::Mat& originalImage, const EdgeBitmap& edgeBitmap, FrameWorkspace& workspace,
+                                const std::vector<Region>& previousRegions, int searchSteps, std::vector<Region>& selectedRegions);
+
     //  Getter 
     double getWindowScale() const { return windowSizeScale; }
     double getStepScale() const { return stepSizeScale; }
@@ -23,6 +35,9 @@ private:
     int targetRegionCount; // d
     double windowSizeScale; // a: Сͼߴı
     double stepSizeScale;   // b: 봰ڴСı
+
+    // ѡ÷ѡǰ d ص
+    void pickTopRegions(std::vector<Region>& candidateRegions, std::vector<Region>& selectedRegions);
 };
 
 #endif // REGION_SELECTOR_H
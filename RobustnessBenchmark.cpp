@@ -0,0 +1,350 @@
+#include "RobustnessBenchmark.h"
+#include "WatermarkEmbedder.h"
+#include "WatermarkExtractor.h"
+#include "WatermarkEncoder.h"
+#include "WatermarkDecoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+// ͼڵµĲ
+struct BenchmarkSample {
+    bool embedded = false;
+    bool attackFailed = false;
+    bool decoded = false;
+    double bitErrorRate = 0.5;
+    double psnr = 0.0;
+    double embedMs = 0.0;
+    double attackMs = 0.0;
+    double extractMs = 0.0;
+    double decodeMs = 0.0;
+};
+
+cv::Mat lumaOf(const cv::Mat& bgrImage) {
+    cv::Mat yuv;
+    cv::cvtColor(bgrImage, yuv, cv::COLOR_BGR2YCrCb);
+    std::vector<cv::Mat> channels;
+    cv::split(yuv, channels);
+    return channels[0];
+}
+}
+
+std::string BenchmarkConfiguration::name() const {
+    std::ostringstream text;
+    text << profile.describe();
+    if (resyncRadius > 0) {
+        text << " resync=" << resyncRadius;
+    }
+    return text.str();
+}
+
+std::vector<BenchmarkConfiguration> BenchmarkConfiguration::parseList(const std::string& spec, const WatermarkProfile& base) {
+    std::vector<BenchmarkConfiguration> configurations;
+    std::stringstream list(spec);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        std::stringstream fields(item);
+        std::string field;
+        std::vector<std::string> values;
+        while (std::getline(fields, field, ':')) {
+            values.push_back(field);
+        }
+        if (values.size() < 3 || values.size() > 4) {
+            throw std::invalid_argument("Configuration must be edge:window:step[:resync]: " + item);
+        }
+        BenchmarkConfiguration configuration;
+        configuration.profile = base;
+        try {
+            configuration.profile.edgeThreshold = std::stoi(values[0]);
+            configuration.profile.windowScale = std::stod(values[1]);
+            configuration.profile.stepScale = std::stod(values[2]);
+            if (values.size() == 4) {
+                configuration.resyncRadius = std::stoi(values[3]);
+            }
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Invalid configuration: " + item);
+        }
+        configurations.push_back(configuration);
+    }
+    if (configurations.empty()) {
+        throw std::invalid_argument("No configurations specified.");
+    }
+    return configurations;
+}
+
+double BenchmarkRow::successRate() const {
+    return images > 0 ? static_cast<double>(decoded) / images : 0.0;
+}
+
+RobustnessBenchmark::RobustnessBenchmark(const std::string& workDirectory) : attackSuite(workDirectory) {
+}
+
+void RobustnessBenchmark::addImage(const std::string& path) {
+    cv::Mat image = cv::imread(path, cv::IMREAD_COLOR);
+    if (image.empty()) {
+        throw std::runtime_error("Could not load benchmark image: " + path);
+    }
+    imageNames.push_back(path);
+    images.push_back(image);
+}
+
+int RobustnessBenchmark::addImagesFromDirectory(const std::string& directory) {
+    std::vector<std::string> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (!entry.is_regular_file()) continue;
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tif" || extension == ".tiff") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    for (const std::string& path : paths) {
+        addImage(path);
+    }
+    return static_cast<int>(paths.size());
+}
+
+void RobustnessBenchmark::addSyntheticImages(int count, cv::Size size, uint64_t seed) {
+    for (int i = 0; i < count; ++i) {
+        imageNames.push_back("synthetic_" + std::to_string(i));
+        images.push_back(makeSyntheticImage(size, seed + i));
+    }
+}
+
+cv::Mat RobustnessBenchmark::makeSyntheticImage(cv::Size size, uint64_t seed) {
+    cv::RNG rng(seed);
+    cv::Mat image(size, CV_8UC3);
+
+    // Խǽ䱳
+    cv::Scalar from(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+    cv::Scalar to(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+    for (int y = 0; y < size.height; ++y) {
+        uchar* row = image.ptr<uchar>(y);
+        for (int x = 0; x < size.width; ++x) {
+            double t = (static_cast<double>(x) / size.width + static_cast<double>(y) / size.height) / 2.0;
+            for (int c = 0; c < 3; ++c) {
+                row[3 * x + c] = cv::saturate_cast<uchar>(from[c] + (to[c] - from[c]) * t);
+            }
+        }
+    }
+
+    // ͼ (ṩǿԵ)
+    int shapeCount = 12 + rng.uniform(0, 12);
+    int extent = std::min(size.width, size.height);
+    for (int i = 0; i < shapeCount; ++i) {
+        cv::Scalar color(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+        cv::Point center(rng.uniform(0, size.width), rng.uniform(0, size.height));
+        int radius = rng.uniform(extent / 40 + 1, extent / 6 + 2);
+        switch (rng.uniform(0, 3)) {
+        case 0:
+            cv::rectangle(image, cv::Rect(center.x - radius, center.y - radius / 2, 2 * radius, radius), color, cv::FILLED);
+            break;
+        case 1:
+            cv::circle(image, center, radius, color, cv::FILLED);
+            break;
+        default:
+            cv::line(image, center, cv::Point(rng.uniform(0, size.width), rng.uniform(0, size.height)), color, rng.uniform(1, 6));
+            break;
+        }
+    }
+
+    //  (ģ)
+    int textureCount = 3 + rng.uniform(0, 3);
+    for (int i = 0; i < textureCount; ++i) {
+        int w = rng.uniform(extent / 8 + 1, extent / 3 + 2);
+        int h = rng.uniform(extent / 8 + 1, extent / 3 + 2);
+        cv::Rect patch(rng.uniform(0, std::max(1, size.width - w)), rng.uniform(0, std::max(1, size.height - h)), w, h);
+        patch &= cv::Rect(0, 0, size.width, size.height);
+        cv::Mat texture(patch.size(), CV_8UC3);
+        rng.fill(texture, cv::RNG::UNIFORM, 0, 256);
+        cv::GaussianBlur(texture, texture, cv::Size(), rng.uniform(0.5, 2.5));
+        cv::Mat target = image(patch);
+        cv::addWeighted(target, 0.4, texture, 0.6, 0.0, target);
+    }
+
+    // ΢Ĵ
+    cv::Mat noise(size, CV_32FC3);
+    rng.fill(noise, cv::RNG::NORMAL, 0.0, 2.0);
+    cv::Mat noisy;
+    image.convertTo(noisy, CV_32F);
+    noisy += noise;
+    noisy.convertTo(image, CV_8U);
+    return image;
+}
+
+std::vector<BenchmarkRow> RobustnessBenchmark::run(const std::vector<BenchmarkConfiguration>& configurations, const std::vector<AttackChain>& chains,
+                                                   bool concurrentTasks) {
+    int imageCount = static_cast<int>(images.size());
+    int chainCount = static_cast<int>(chains.size());
+    int taskCount = static_cast<int>(configurations.size()) * imageCount;
+    std::vector<BenchmarkSample> samples(static_cast<size_t>(taskCount) * chainCount);
+
+    // ÿ = һ  һͼ񣬸ԳǶ / ȡ״̬
+    auto runTasks = [&](const cv::Range& range) {
+        for (int task = range.start; task < range.end; ++task) {
+            const BenchmarkConfiguration& configuration = configurations[task / imageCount];
+            int imageIndex = task % imageCount;
+            const cv::Mat& original = images[imageIndex];
+            BenchmarkSample* taskSamples = &samples[static_cast<size_t>(task) * chainCount];
+
+            char watermarkText[16];
+            sprintf_s(watermarkText, "BM%06d", imageIndex % 1000000);
+
+            WatermarkEncoder encoder;
+            WatermarkDecoder decoder;
+            BitStream expectedBits = encoder.encodeWatermark(watermarkText);
+            WatermarkEmbedder embedder(configuration.profile);
+            WatermarkExtractor extractor(static_cast<int>(expectedBits.size()), configuration.profile);
+            if (configuration.resyncRadius > 0) {
+                extractor.setGridResync(configuration.resyncRadius);
+            }
+
+            // 1. Ƕ ( Y ͨϾ͵޸)
+            Clock::time_point stage = Clock::now();
+            cv::Mat watermarked;
+            try {
+                cv::Mat yuv;
+                cv::cvtColor(original, yuv, cv::COLOR_BGR2YCrCb);
+                std::vector<cv::Mat> channels;
+                cv::split(yuv, channels);
+                embedder.embedWatermarkInPlace(channels[0], watermarkText);
+                cv::merge(channels, yuv);
+                cv::cvtColor(yuv, watermarked, cv::COLOR_YCrCb2BGR);
+            } catch (const std::exception&) {
+                continue; // δǶ룺 embedded = false
+            }
+            double embedMs = elapsedMs(stage);
+            double psnr = cv::PSNR(original, watermarked);
+
+            std::vector<BitStream> hardBits;
+            std::vector<std::vector<double>> softBits;
+            for (int c = 0; c < chainCount; ++c) {
+                BenchmarkSample& sample = taskSamples[c];
+                sample.embedded = true;
+                sample.embedMs = embedMs;
+                sample.psnr = psnr;
+
+                // 2. 
+                stage = Clock::now();
+                cv::Mat attacked;
+                try {
+                    attacked = attackSuite.apply(watermarked, chains[c], static_cast<uint64_t>(task) * 7919 + c, task * chainCount + c);
+                } catch (const std::exception&) {
+                    sample.attackFailed = true;
+                    continue;
+                }
+                sample.attackMs = elapsedMs(stage);
+
+                // 3. ȡо
+                stage = Clock::now();
+                try {
+                    extractor.extractRegionBits(lumaOf(attacked), hardBits, softBits);
+                } catch (const std::exception&) {
+                    sample.extractMs = elapsedMs(stage);
+                    continue; // ȡʧܣBER  0.5δ
+                }
+                sample.extractMs = elapsedMs(stage);
+
+                // 4. ش
+                stage = Clock::now();
+                BitStream votedBits = BitStream::atLeast(hardBits, 2);
+                size_t errors = 0;
+                for (size_t i = 0; i < expectedBits.size(); ++i) {
+                    errors += votedBits[i] != expectedBits[i];
+                }
+                sample.bitErrorRate = static_cast<double>(errors) / expectedBits.size();
+                std::string decodedText;
+                sample.decoded = decoder.tryDecodeWatermark(votedBits, decodedText) && decodedText == watermarkText;
+                sample.decodeMs = elapsedMs(stage);
+            }
+        }
+    };
+    if (concurrentTasks) {
+        cv::parallel_for_(cv::Range(0, taskCount), runTasks, taskCount);
+    } else {
+        runTasks(cv::Range(0, taskCount));
+    }
+
+    //  (, ) 
+    std::vector<BenchmarkRow> rows;
+    for (size_t k = 0; k < configurations.size(); ++k) {
+        for (int c = 0; c < chainCount; ++c) {
+            BenchmarkRow row;
+            row.configuration = configurations[k];
+            row.attackName = AttackSuite::chainName(chains[c]);
+            for (int imageIndex = 0; imageIndex < imageCount; ++imageIndex) {
+                const BenchmarkSample& sample = samples[(k * imageCount + imageIndex) * chainCount + c];
+                if (!sample.embedded) {
+                    ++row.embedFailures;
+                    continue;
+                }
+                if (sample.attackFailed) {
+                    ++row.attackFailures;
+                    continue;
+                }
+                ++row.images;
+                row.decoded += sample.decoded ? 1 : 0;
+                row.bitErrorRate += sample.bitErrorRate;
+                row.psnr += sample.psnr;
+                row.embedMs += sample.embedMs;
+                row.attackMs += sample.attackMs;
+                row.extractMs += sample.extractMs;
+                row.decodeMs += sample.decodeMs;
+            }
+            if (row.images > 0) {
+                row.bitErrorRate /= row.images;
+                row.psnr /= row.images;
+                row.embedMs /= row.images;
+                row.attackMs /= row.images;
+                row.extractMs /= row.images;
+                row.decodeMs /= row.images;
+            }
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+void RobustnessBenchmark::printReport(const std::vector<BenchmarkRow>& rows, std::ostream& out) {
+    char line[512];
+    sprintf_s(line, "%-64s %-20s %7s %8s %7s %7s %9s %9s %10s %9s",
+              "configuration", "attack", "images", "success", "BER", "PSNR", "embed_ms", "attack_ms", "extract_ms", "decode_ms");
+    out << line << std::endl;
+    for (const BenchmarkRow& row : rows) {
+        sprintf_s(line, "%-64s %-20s %7d %7.1f%% %7.4f %7.2f %9.1f %9.1f %10.1f %9.2f",
+                  row.configuration.name().c_str(), row.attackName.c_str(), row.images, row.successRate() * 100.0,
+                  row.bitErrorRate, row.psnr, row.embedMs, row.attackMs, row.extractMs, row.decodeMs);
+        out << line;
+        if (row.embedFailures > 0) out << "  (" << row.embedFailures << " not embedded)";
+        if (row.attackFailures > 0) out << "  (" << row.attackFailures << " attack failures)";
+        out << std::endl;
+    }
+}
+
+void RobustnessBenchmark::writeCsv(const std::vector<BenchmarkRow>& rows, const std::string& path) {
+    std::ofstream csv(path);
+    if (!csv) {
+        throw std::runtime_error("Could not write benchmark report: " + path);
+    }
+    csv << "edge_threshold,gaussian_sigma,window_scale,step_scale,canny_low,canny_high,post_process_threshold,resync_radius,attack,images,embed_failures,attack_failures,decoded,success_rate,"
+           "bit_error_rate,psnr_db,embed_ms,attack_ms,extract_ms,decode_ms\n";
+    for (const BenchmarkRow& row : rows) {
+        const WatermarkProfile& p = row.configuration.profile;
+        csv << p.edgeThreshold << ',' << p.gaussianSigma << ',' << p.windowScale << ',' << p.stepScale << ',' << p.cannyLow << ','
+            << p.cannyHigh << ',' << p.postProcessThreshold << ',' << row.configuration.resyncRadius << ',' << row.attackName << ','
+            << row.images << ',' << row.embedFailures << ',' << row.attackFailures << ',' << row.decoded << ',' << row.successRate() << ','
+            << row.bitErrorRate << ',' << row.psnr << ',' << row.embedMs << ',' << row.attackMs << ',' << row.extractMs << ',' << row.decodeMs << '\n';
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef ROBUSTNESS_BENCHMARK_H
+#define ROBUSTNESS_BENCHMARK_H
+
+#include "AttackSuite.h"
+#include "WatermarkProfile.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// һȽϵǶ / ȡ (Ƕȡʹֵͬ)
+struct BenchmarkConfiguration {
+    WatermarkProfile profile; // Ե⡢ѡ鴦
+    int resyncRadius = 0; // ȡʱͬ뾶 (0 ʾ)
+
+    std::string name() const;
+
+    //  "edge:window:step[:resync]" Ķŷָб "5:0.25:0.25,3:0.2:0.25:8" (ȡ base ֵ)
+    static std::vector<BenchmarkConfiguration> parseList(const std::string& spec, const WatermarkProfile& base = WatermarkProfile());
+};
+
+// ĳĳµĻܽ (ʱΪÿͼƽֵ)
+struct BenchmarkRow {
+    BenchmarkConfiguration configuration;
+    std::string attackName;
+    int images = 0; // ɹǶͼ
+    int embedFailures = 0; // ѡǶԭδǶͼ
+    int attackFailures = 0; // ʧ (Ҳ ffmpeg) Ĵͳ
+    int decoded = 0; // Ƕһµͼ
+    double bitErrorRate = 0.0; // 4 ıش (ȡʧܼ 0.5)
+    double psnr = 0.0; // ˮӡͼԭͼ PSNR (dB)
+    double embedMs = 0.0;
+    double attackMs = 0.0;
+    double extractMs = 0.0; // Ե⡢ѡо
+    double decodeMs = 0.0; //  RS 
+
+    double successRate() const;
+};
+
+// ³ / ׼ͼÿͼÿǶ룬ʩÿȡ
+// ͳƽɹʡشʡPSNR ͸׶κʱ  ͼڶϲִС
+class RobustnessBenchmark {
+public:
+    explicit RobustnessBenchmark(const std::string& workDirectory = "temp_bench");
+
+    // һűͼ (޷ȡʱ׳ std::runtime_error)
+    void addImage(const std::string& path);
+    // Ŀ¼µȫͼļ (ļ)ؼ
+    int addImagesFromDirectory(const std::string& directory);
+    //  count źϳͼ (䱳ͼΡͬһ seed ͬ)
+    void addSyntheticImages(int count, cv::Size size, uint64_t seed = 1);
+
+    size_t getImageCount() const { return images.size(); }
+
+    // ȫ빥 configurations.size() * chains.size() С
+    // concurrentTasks Ϊ false ʱִ (Ƕ / ȡڲĲв)ʱúĵӰ죬
+    // Ƚϲͬٶʱʹ
+    std::vector<BenchmarkRow> run(const std::vector<BenchmarkConfiguration>& configurations, const std::vector<AttackChain>& chains,
+                                  bool concurrentTasks = true);
+
+    static void printReport(const std::vector<BenchmarkRow>& rows, std::ostream& out);
+    static void writeCsv(const std::vector<BenchmarkRow>& rows, const std::string& path);
+
+    static cv::Mat makeSyntheticImage(cv::Size size, uint64_t seed);
+
+private:
+    std::vector<std::string> imageNames;
+    std::vector<cv::Mat> images; // BGR
+    AttackSuite attackSuite;
+};
+
+#endif // ROBUSTNESS_BENCHMARK_H
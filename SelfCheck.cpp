@@ -0,0 +1,363 @@
+#include "SelfCheck.h"
+#include "RobustnessBenchmark.h"
+#include "AttackSuite.h"
+#include "WatermarkEmbedder.h"
+#include "WatermarkExtractor.h"
+#include "EdgeDetector.h"
+#include "LiveStreamEmbedder.h"
+#include "WatermarkEncoder.h"
+#include "WatermarkDecoder.h"
+#include "utils.h"
+#include <atomic>
+#include <bitset>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <opencv2/opencv.hpp>
+
+namespace {
+// ȫ operator new  (ֻ AllocationCounter ڼ߳)
+std::atomic<bool> countingEnabled(false);
+std::atomic<size_t> newCount(0);
+std::atomic<size_t> newBytes(0);
+
+// װ OpenCV ĬϷͳ Mat ݵķ (Mat ݲ operator new)
+class CountingMatAllocator : public cv::MatAllocator {
+public:
+    CountingMatAllocator() : count(0), bytes(0), base(cv::Mat::getStdAllocator()) {}
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+        if (data == nullptr) {
+            size_t total = CV_ELEM_SIZE(type);
+            for (int i = 0; i < dims; ++i) {
+                total *= static_cast<size_t>(sizes[i]);
+            }
+            ++count;
+            bytes += total;
+        }
+        return base->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override {
+        return base->allocate(data, accessFlags, usageFlags);
+    }
+
+    void deallocate(cv::UMatData* data) const override {
+        base->deallocate(data);
+    }
+
+    mutable std::atomic<size_t> count;
+    mutable std::atomic<size_t> bytes;
+
+private:
+    const cv::MatAllocator* base;
+};
+
+// ͳ䣻ʱָ OpenCV ĬϷ
+class AllocationCounter {
+public:
+    AllocationCounter() {
+        cv::Mat::setDefaultAllocator(&matAllocator);
+        newCount = 0;
+        newBytes = 0;
+        countingEnabled = true;
+    }
+    ~AllocationCounter() {
+        countingEnabled = false;
+        cv::Mat::setDefaultAllocator(nullptr);
+    }
+
+    size_t newCalls() const { return newCount; }
+    size_t newTotalBytes() const { return newBytes; }
+    size_t matCalls() const { return matAllocator.count; }
+    size_t matTotalBytes() const { return matAllocator.bytes; }
+
+private:
+    CountingMatAllocator matAllocator;
+};
+
+cv::Mat lumaOf(const cv::Mat& bgrImage) {
+    cv::Mat yuv;
+    cv::cvtColor(bgrImage, yuv, cv::COLOR_BGR2YCrCb);
+    std::vector<cv::Mat> channels;
+    cv::split(yuv, channels);
+    return channels[0];
+}
+}
+
+void* operator new(std::size_t size) {
+    if (countingEnabled.load(std::memory_order_relaxed)) {
+        newCount.fetch_add(1, std::memory_order_relaxed);
+        newBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+std::vector<std::string> SelfCheck::names() {
+    return { "workspace", "stripes", "resync", "stream" };
+}
+
+int SelfCheck::run(const std::vector<std::string>& selected, std::ostream& out) {
+    std::vector<std::string> checks = selected.empty() ? names() : selected;
+    int failures = 0;
+    for (const std::string& name : checks) {
+        bool passed = false;
+        out << "[" << name << "]" << std::endl;
+        try {
+            if (name == "workspace") {
+                passed = checkWorkspace(out);
+            } else if (name == "stripes") {
+                passed = checkStripes(out);
+            } else if (name == "resync") {
+                passed = checkResync(out);
+            } else if (name == "stream") {
+                passed = checkStream(out);
+            } else {
+                out << "  unknown check" << std::endl;
+            }
+        } catch (const std::exception& e) {
+            out << "  error: " << e.what() << std::endl;
+        }
+        out << "  " << (passed ? "PASS" : "FAIL") << std::endl;
+        if (!passed) {
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+bool SelfCheck::checkWorkspace(std::ostream& out) {
+    const std::string watermarkText = "SELFTEST";
+    cv::Mat original = lumaOf(RobustnessBenchmark::makeSyntheticImage(cv::Size(1280, 720), 11));
+    BitStream encodedBits = WatermarkEncoder().encodeWatermark(watermarkText);
+    int watermarkLength = static_cast<int>(encodedBits.size());
+
+    WatermarkProfile profile;
+    WatermarkEmbedder embedder(profile);
+    WatermarkExtractor extractor(watermarkLength, profile);
+    cv::Mat frame = original.clone();
+
+    //  0 Ԥȣ 12 ͳƣÿȰԭͼͬһ frame ڴ
+    const int rounds = 3;
+    size_t newCalls[rounds] = {}, newBytesPerRound[rounds] = {}, matCalls[rounds] = {}, matBytes[rounds] = {};
+    size_t workspaceMisses[rounds] = {};
+    bool decodedEveryRound = true;
+    std::string decodedText;
+    for (int round = 0; round < rounds; ++round) {
+        original.copyTo(frame);
+        double confidence = 0.0;
+        bool found = false;
+        {
+            AllocationCounter counter;
+            embedder.embedWatermarkInPlace(frame, watermarkText);
+            found = extractor.tryExtract(frame, decodedText, confidence);
+            newCalls[round] = counter.newCalls();
+            newBytesPerRound[round] = counter.newTotalBytes();
+            matCalls[round] = counter.matCalls();
+            matBytes[round] = counter.matTotalBytes();
+        }
+        workspaceMisses[round] = embedder.getWorkspaceAllocationCount() + extractor.getWorkspaceAllocationCount();
+        decodedEveryRound = decodedEveryRound && found && decodedText == watermarkText;
+        out << "  round " << round << (round == 0 ? " (warm-up)" : "") << ": operator new " << newCalls[round] << " call(s) / "
+            << newBytesPerRound[round] << " bytes, Mat " << matCalls[round] << " allocation(s) / " << matBytes[round]
+            << " bytes, workspace misses " << workspaceMisses[round] << ", decoded " << (found ? decodedText : "-") << std::endl;
+    }
+
+    bool noWorkspaceMisses = workspaceMisses[2] == workspaceMisses[0];
+    bool steady = newCalls[1] == newCalls[2] && newBytesPerRound[1] == newBytesPerRound[2]
+        && matCalls[1] == matCalls[2] && matBytes[1] == matBytes[2];
+    out << "  workspace reused after warm-up: " << (noWorkspaceMisses ? "yes" : "no")
+        << "; identical allocations in rounds 1 and 2: " << (steady ? "yes" : "no") << std::endl;
+
+    // ֡ļ OpenCV ڲʱڴ (Cannydctparallel_for_ )޷뱾֣
+    //  OpenCV Ķ RS 뵥ԤȺΪ 0
+    std::vector<BitStream> regionVotes(4, encodedBits);
+    BitStream votedBits;
+    WatermarkDecoder decoder;
+    ScopedLibraryLogMute mute;
+    BitStream::atLeast(regionVotes, 2, votedBits);
+    decoder.tryDecodeWatermark(votedBits, decodedText);
+    bool decodeFound = false;
+    size_t decodeNewCalls = 0, decodeMatCalls = 0;
+    {
+        AllocationCounter counter;
+        BitStream::atLeast(regionVotes, 2, votedBits);
+        decodeFound = decoder.tryDecodeWatermark(votedBits, decodedText);
+        decodeNewCalls = counter.newCalls();
+        decodeMatCalls = counter.matCalls();
+    }
+    bool decodeAllocationFree = decodeNewCalls == 0 && decodeMatCalls == 0;
+    out << "  vote + RS decode after warm-up: operator new " << decodeNewCalls << " call(s), Mat " << decodeMatCalls
+        << " allocation(s), decoded " << (decodeFound ? decodedText : "-") << std::endl;
+    return decodedEveryRound && noWorkspaceMisses && steady && decodeAllocationFree && decodeFound && decodedText == watermarkText;
+}
+
+bool SelfCheck::checkStripes(std::ostream& out) {
+    const int stripeRows = 128;
+    const cv::Size sizes[] = { cv::Size(1920, 1080), cv::Size(3840, 2160) };
+
+    // ͬһ֡ĴԵͼλȽ (ϳͼʵϵĲδ)
+    bool passed = true;
+    for (const cv::Size& size : sizes) {
+        cv::Mat image = lumaOf(RobustnessBenchmark::makeSyntheticImage(size, 23));
+        FrameWorkspace serialWorkspace, stripedWorkspace;
+        EdgeDetector serialDetector;
+        EdgeDetector stripedDetector;
+        stripedDetector.setParallelStripes(stripeRows);
+        const EdgeBitmap& serialEdges = serialDetector.detectEdgeBitmap(image, serialWorkspace);
+        const EdgeBitmap& stripedEdges = stripedDetector.detectEdgeBitmap(image, stripedWorkspace);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < serialEdges.words().size(); ++i) {
+            mismatches += std::bitset<64>(serialEdges.words()[i] ^ stripedEdges.words()[i]).count();
+        }
+        int serialCount = serialEdges.countAll();
+        double mismatchRatio = serialCount > 0 ? static_cast<double>(mismatches) / serialCount : 0.0;
+        out << "  " << image.cols << "x" << image.rows << ", " << stripeRows << "-row stripes: " << serialCount << " serial edge pixels, "
+            << mismatches << " differ (" << mismatchRatio * 100.0 << "%, limit 1%)" << std::endl;
+        passed = passed && serialCount > 0 && mismatchRatio <= 0.01;
+    }
+    return passed;
+}
+
+bool SelfCheck::checkResync(std::ostream& out) {
+    const std::string watermarkText = "RESYNC";
+    const int searchRadius = 16;
+    std::vector<AttackChain> chains = AttackSuite::parseChains("crop:0.02");
+    AttackSuite attackSuite((std::filesystem::temp_directory_path() / "wm_selfcheck_attacks").string());
+    int watermarkLength = static_cast<int>(WatermarkEncoder().encodeWatermark(watermarkText).size());
+    WatermarkProfile profile;
+
+    //  benchmark ͬĺϳͼߴ빥
+    int decodedWithoutResync = 0, decodedWithResync = 0;
+    const int imageCount = 4;
+    for (int i = 0; i < imageCount; ++i) {
+        cv::Mat image = RobustnessBenchmark::makeSyntheticImage(cv::Size(512, 512), 100 + i);
+        cv::Mat yuv;
+        cv::cvtColor(image, yuv, cv::COLOR_BGR2YCrCb);
+        std::vector<cv::Mat> channels;
+        cv::split(yuv, channels);
+        WatermarkEmbedder embedder(profile);
+        embedder.embedWatermarkInPlace(channels[0], watermarkText);
+        cv::merge(channels, yuv);
+        cv::cvtColor(yuv, image, cv::COLOR_YCrCb2BGR);
+        cv::Mat cropped = lumaOf(attackSuite.apply(image, chains[0], static_cast<uint64_t>(i), i));
+
+        std::string decodedText;
+        double confidence = 0.0;
+        WatermarkExtractor plainExtractor(watermarkLength, profile);
+        if (plainExtractor.tryExtract(cropped, decodedText, confidence) && decodedText == watermarkText) {
+            ++decodedWithoutResync;
+        }
+        WatermarkExtractor resyncExtractor(watermarkLength, profile);
+        resyncExtractor.setGridResync(searchRadius);
+        if (resyncExtractor.tryExtract(cropped, decodedText, confidence) && decodedText == watermarkText) {
+            ++decodedWithResync;
+        }
+    }
+    out << "  crop:0.02 on " << imageCount << " synthetic 512x512 images: decoded " << decodedWithoutResync << " without resync, "
+        << decodedWithResync << " with resync radius " << searchRadius << std::endl;
+    return decodedWithResync == imageCount;
+}
+
+bool SelfCheck::checkStream(std::ostream& out) {
+    const std::string watermarkText = "STREAM";
+    const int width = 1280, height = 720, frameCount = 90, period = 30;
+    std::filesystem::path workDirectory = std::filesystem::temp_directory_path() / "wm_selfcheck_stream";
+    std::filesystem::remove_all(workDirectory);
+    std::filesystem::create_directories(workDirectory);
+    std::string work = workDirectory.string();
+
+    // 1. ϳ֡ (ͬһ֡) ffmpeg ת޷Χ yuv420p ԭʼʵʹ÷ʽͬ
+    cv::Mat background = RobustnessBenchmark::makeSyntheticImage(cv::Size(width, height), 53);
+    cv::RNG rng(53);
+    for (int i = 0; i < frameCount; ++i) {
+        cv::Mat noise(background.size(), CV_32FC3);
+        rng.fill(noise, cv::RNG::NORMAL, 0.0, 1.5);
+        cv::Mat frame;
+        background.convertTo(frame, CV_32F);
+        frame += noise;
+        frame.convertTo(frame, CV_8U);
+        char name[32];
+        std::snprintf(name, sizeof(name), "/source_%03d.png", i);
+        cv::imwrite(work + name, frame);
+    }
+    std::string toRaw = "ffmpeg -y -v error -framerate 30 -i \"" + work + "/source_%03d.png\" -f rawvideo -pix_fmt yuv420p \"" + work + "/in.yuv\"";
+    if (std::system(toRaw.c_str()) != 0) {
+        throw std::runtime_error("ffmpeg is required for the stream check.");
+    }
+
+    // 2.  stream-embed ͬ֡ (ԤſÿڶǶ)
+    LiveStreamEmbedder streamEmbedder(width, height, watermarkText, period, 1000.0);
+    std::vector<uint8_t> frame(streamEmbedder.getFrameBytes());
+    FILE* input = std::fopen((work + "/in.yuv").c_str(), "rb");
+    FILE* output = std::fopen((work + "/out.yuv").c_str(), "wb");
+    if (input == nullptr || output == nullptr) {
+        if (input != nullptr) std::fclose(input);
+        if (output != nullptr) std::fclose(output);
+        throw std::runtime_error("Could not open the raw stream files in " + work);
+    }
+    while (std::fread(frame.data(), 1, frame.size(), input) == frame.size()) {
+        streamEmbedder.processFrame(frame.data());
+        std::fwrite(frame.data(), 1, frame.size(), output);
+    }
+    std::fclose(input);
+    std::fclose(output);
+    LiveStreamStats stats = streamEmbedder.getStats();
+
+    // 3. H.264  video-extract fixed ķʽÿ 30 ֡ĵ 1 ֡ȡ
+    char size[32];
+    std::snprintf(size, sizeof(size), "%dx%d", width, height);
+    std::string encode = "ffmpeg -y -v error -f rawvideo -pix_fmt yuv420p -s " + std::string(size) + " -framerate 30 -i \"" + work
+                       + "/out.yuv\" -c:v libx264 -crf 18 -g 30 \"" + work + "/out.mp4\"";
+    std::string exportFrames = "ffmpeg -y -v error -i \"" + work + "/out.mp4\" -vf \"select=not(mod(n\\,30))\" -vsync vfr -q:v 2 \""
+                             + work + "/frame_%05d.png\"";
+    if (std::system(encode.c_str()) != 0 || std::system(exportFrames.c_str()) != 0) {
+        throw std::runtime_error("ffmpeg failed to encode or export the stream.");
+    }
+    int watermarkLength = static_cast<int>(WatermarkEncoder().encodeWatermark(watermarkText).size());
+    WatermarkExtractor extractor(watermarkLength, WatermarkProfile());
+    int exported = 0, decoded = 0;
+    for (int index = 1; ; ++index) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/frame_%05d.png", index);
+        cv::Mat exportedFrame = cv::imread(work + name, cv::IMREAD_COLOR);
+        if (exportedFrame.empty()) {
+            break;
+        }
+        ++exported;
+        std::string decodedText;
+        double confidence = 0.0;
+        if (extractor.tryExtract(lumaOf(exportedFrame), decodedText, confidence) && decodedText == watermarkText) {
+            ++decoded;
+        }
+    }
+    std::filesystem::remove_all(workDirectory);
+
+    out << "  " << frameCount << " frames " << width << "x" << height << ", period " << period << ": " << stats.embedded << " embedded, "
+        << stats.skipped << " skipped; after H.264 (crf 18) " << decoded << " of " << exported << " exported frame(s) decoded" << std::endl;
+    return stats.embedded == frameCount / period && exported == stats.embedded && decoded == exported;
+}
@@ -0,0 +1,33 @@
+#ifndef SELF_CHECK_H
+#define SELF_CHECK_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Լ죺ںϳͼʵʵֲ (֡ڴ)ӡֵǷͨ
+// ֻʹãSelfCheck.cpp 滻ȫ operator new ͳƷҪ libwatermark
+class SelfCheck {
+public:
+    // ȫ (˳)
+    static std::vector<std::string> names();
+
+    //  selected еļ (Ϊʱȫ)δͨ (δ֪ƼΪδͨ)
+    static int run(const std::vector<std::string>& selected, std::ostream& out);
+
+private:
+    // ֱͬʵڶǶȡڼķ䣺ڲزӦδУε operator new  Mat 
+    // ֽȫͬ (µ OpenCV ڲ)ԤȺ RS 벻Ӧκη
+    static bool checkWorkspace(std::ostream& out);
+
+    // ϳ 1080p / 4K ͼϷбԵ봮еĲ (ΪбԵ 1%)
+    static bool checkStripes(std::ostream& out);
+
+    // ׼ԵĲü (crop:0.02) 󣬲ͬͬ (뾶 16) ȡͬܽ
+    static bool checkResync(std::ostream& out);
+
+    // stream-embed -> ffmpeg (H.264) ->  video-extract fixed ͬĳ֡ȡÿǶ֡ (Ҫ ffmpeg)
+    static bool checkStream(std::ostream& out);
+};
+
+#endif // SELF_CHECK_H
@@ -0,0 +1,40 @@
+#include "ShardedVoteTable.h"
+#include <functional>
+#include <stdexcept>
+
+ShardedVoteTable::ShardedVoteTable(size_t shardCount)
+    : shards(shardCount) {
+    if (shardCount == 0) {
+        throw std::invalid_argument("Vote table needs at least one shard.");
+    }
+}
+
+void ShardedVoteTable::add(const std::string& text, int votes) {
+    Shard& shard = shards[std::hash<std::string>()(text) % shards.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.counts[text] += votes;
+}
+
+std::map<std::string, int> ShardedVoteTable::snapshot() const {
+    std::map<std::string, int> merged;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.counts) {
+            merged[entry.first] += entry.second;
+        }
+    }
+    return merged;
+}
+
+bool ShardedVoteTable::top(std::string& text, int& votes) const {
+    std::map<std::string, int> merged = snapshot();
+    bool found = false;
+    for (const auto& entry : merged) {
+        if (!found || entry.second > votes) {
+            text = entry.first;
+            votes = entry.second;
+            found = true;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,31 @@
+#ifndef SHARDED_VOTE_TABLE_H
+#define SHARDED_VOTE_TABLE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ƬˮӡƱˮӡıĹϣֵƬÿƬһ
+// ȡ߳ͬʱͶƱʱֻ䵽ͬһƬʱŻȴ
+class ShardedVoteTable {
+public:
+    explicit ShardedVoteTable(size_t shardCount = 16);
+
+    void add(const std::string& text, int votes = 1);
+
+    // ϲƬõƱ
+    std::map<std::string, int> snapshot() const;
+
+    // Ʊˮӡ (ͬƱʱȡֵС)Ϊʱ false
+    bool top(std::string& text, int& votes) const;
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::map<std::string, int> counts;
+    };
+    std::vector<Shard> shards;
+};
+
+#endif // SHARDED_VOTE_TABLE_H
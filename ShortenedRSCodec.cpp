@@ -0,0 +1,22 @@
+#include "ShortenedRSCodec.h"
+
+GaloisField256::GaloisField256() {
+    int value = 1;
+    for (int e = 0; e < 255; ++e) {
+        expTable[e] = static_cast<uint8_t>(value);
+        logTable[value] = e;
+        value <<= 1;
+        if (value & 0x100) {
+            value ^= 0x11D;
+        }
+    }
+    for (int e = 255; e < 512; ++e) {
+        expTable[e] = expTable[e - 255];
+    }
+    logTable[0] = 0; // log(0) ޶壬÷ж
+}
+
+const GaloisField256& GaloisField256::instance() {
+    static const GaloisField256 field;
+    return field;
+}
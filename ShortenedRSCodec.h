@@ -0,0 +1,284 @@
+#ifndef SHORTENED_RS_CODEC_H
+#define SHORTENED_RS_CODEC_H
+
+#include "BitStream.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// GF(2^8) 㣬ԭʽ x^8 + x^4 + x^3 + x^2 + 1 (0x11D schifra primitive_polynomial06 ͬ)
+class GaloisField256 {
+public:
+    static const GaloisField256& instance();
+
+    // alpha^ee ȡֵ [0, 510)
+    uint8_t exp(int e) const { return expTable[e]; }
+    // log_alpha(a)a Ϊ 0
+    int log(uint8_t a) const { return logTable[a]; }
+
+    uint8_t mul(uint8_t a, uint8_t b) const {
+        if (a == 0 || b == 0) return 0;
+        return expTable[logTable[a] + logTable[b]];
+    }
+    uint8_t div(uint8_t a, uint8_t b) const {
+        if (a == 0) return 0;
+        return expTable[logTable[a] + 255 - logTable[b]];
+    }
+    // alpha^ee Ϊ
+    uint8_t alphaPow(long long e) const {
+        long long r = e % 255;
+        if (r < 0) r += 255;
+        return expTable[r];
+    }
+
+private:
+    GaloisField256();
+
+    uint8_t expTable[512]; // ڣ˷ʱȡģ
+    int logTable[256];
+};
+
+//  RS RS(CodeLength, DataLength) ֻǰ PayloadLength ݷźȫУţ
+// ݷŹ̶Ϊ 0 Ҳ봫䡣
+// ֲԭ schifra ÷һ£Ϊ [payload | 0 ... 0 | fec]payload[0] Ϊߴ
+// ɶʽΪ alpha^GeneratorIndex ... alpha^(GeneratorIndex + FecLength - 1)
+// ֻ PayloadLength + FecLength ֽڣֻЩλϼ㡣
+template <std::size_t CodeLength, std::size_t DataLength, std::size_t PayloadLength, std::size_t GeneratorIndex = 120>
+class ShortenedRSCodec {
+public:
+    static const std::size_t FecLength = CodeLength - DataLength;
+    static const std::size_t PayloadSize = PayloadLength;
+    static const std::size_t CodewordLength = PayloadLength + FecLength;
+
+    static_assert(CodeLength == 255, "ShortenedRSCodec: only GF(2^8) full-length codes are supported.");
+    static_assert(DataLength < CodeLength, "ShortenedRSCodec: data length must be smaller than code length.");
+    static_assert(PayloadLength > 0 && PayloadLength <= DataLength, "ShortenedRSCodec: payload must fit in the data symbols.");
+    static_assert(FecLength % 2 == 0, "ShortenedRSCodec: FEC length must be even.");
+
+    ShortenedRSCodec() : field(GaloisField256::instance()) {
+        // ÿλöӦĶʽpayload[j] -> n-1-jfec[i] -> FecLength-1-i
+        for (std::size_t k = 0; k < CodewordLength; ++k) {
+            positionDegree[k] = (k < PayloadLength) ? static_cast<int>(CodeLength - 1 - k) : static_cast<int>(CodewordLength - 1 - k);
+        }
+
+        // ɶʽ g(x) = prod (x + alpha^(GeneratorIndex + i))generator[d] Ϊ x^d ϵ
+        uint8_t generator[FecLength + 1] = { 0 };
+        generator[0] = 1;
+        for (std::size_t i = 0; i < FecLength; ++i) {
+            uint8_t root = field.alphaPow(static_cast<long long>(GeneratorIndex + i));
+            for (std::size_t d = i + 1; d > 0; --d) {
+                generator[d] = generator[d - 1] ^ field.mul(generator[d], root);
+            }
+            generator[0] = field.mul(generator[0], root);
+        }
+
+        // parityRows[j] = x^(n-1-j) mod g(x) fec ˳ (ߴǰ) 
+        uint8_t remainder[FecLength] = { 0 };
+        remainder[0] = 1; // x^0
+        int degree = 0;
+        for (std::size_t j = PayloadLength; j-- > 0;) {
+            int targetDegree = static_cast<int>(CodeLength - 1 - j);
+            for (; degree < targetDegree; ++degree) {
+                // remainder *= x (mod g)
+                uint8_t carry = remainder[FecLength - 1];
+                for (std::size_t d = FecLength - 1; d > 0; --d) {
+                    remainder[d] = remainder[d - 1] ^ field.mul(carry, generator[d]);
+                }
+                remainder[0] = field.mul(carry, generator[0]);
+            }
+            for (std::size_t i = 0; i < FecLength; ++i) {
+                parityRows[j][i] = remainder[FecLength - 1 - i];
+            }
+        }
+
+        // ʽsyndromeLog[k][i] = (GeneratorIndex + i) * deg_k mod 255
+        for (std::size_t k = 0; k < CodewordLength; ++k) {
+            for (std::size_t i = 0; i < FecLength; ++i) {
+                syndromeLog[k][i] = static_cast<int>(((GeneratorIndex + i) * static_cast<std::size_t>(positionDegree[k])) % 255);
+            }
+        }
+    }
+
+    // 룺codeword ǰ PayloadLength ֽΪ payload FecLength ֽдУ
+    void encode(const uint8_t* payload, uint8_t* codeword) const {
+        uint8_t parity[FecLength] = { 0 };
+        for (std::size_t j = 0; j < PayloadLength; ++j) {
+            codeword[j] = payload[j];
+            if (payload[j] == 0) continue;
+            int logValue = field.log(payload[j]);
+            for (std::size_t i = 0; i < FecLength; ++i) {
+                uint8_t row = parityRows[j][i];
+                if (row != 0) {
+                    parity[i] ^= field.exp(logValue + field.log(row));
+                }
+            }
+        }
+        for (std::size_t i = 0; i < FecLength; ++i) {
+            codeword[PayloadLength + i] = parity[i];
+        }
+    }
+
+    // 룺ȡ message ǰ PayloadLength ֽ (㲹 0)ְλ (ÿֽڸλǰ) ׷ӵ bits
+    void encode(const std::string& message, BitStream& bits) const {
+        uint8_t payload[PayloadLength] = { 0 };
+        for (std::size_t j = 0; j < PayloadLength && j < message.size(); ++j) {
+            payload[j] = static_cast<uint8_t>(message[j]);
+        }
+        uint8_t codeword[CodewordLength];
+        encode(payload, codeword);
+        for (std::size_t k = 0; k < CodewordLength; ++k) {
+            bits.appendByte(codeword[k]);
+        }
+    }
+
+    // ԭؾɹ (޴Ѿ)  true
+    // λδĲλΪʧ
+    bool decode(uint8_t* codeword) const {
+        uint8_t syndromes[FecLength];
+        if (!computeSyndromes(codeword, syndromes)) {
+            return true;
+        }
+
+        // Berlekamp-Massey λöʽ lambda
+        uint8_t lambda[FecLength + 1] = { 0 };
+        uint8_t previous[FecLength + 1] = { 0 };
+        uint8_t temp[FecLength + 1];
+        lambda[0] = 1;
+        previous[0] = 1;
+        int errorCount = 0;
+        int shift = 1;
+        uint8_t previousDiscrepancy = 1;
+        for (std::size_t n = 0; n < FecLength; ++n) {
+            uint8_t discrepancy = syndromes[n];
+            for (int i = 1; i <= errorCount; ++i) {
+                discrepancy ^= field.mul(lambda[i], syndromes[n - i]);
+            }
+            if (discrepancy == 0) {
+                ++shift;
+                continue;
+            }
+            uint8_t scale = field.div(discrepancy, previousDiscrepancy);
+            std::copy(lambda, lambda + FecLength + 1, temp);
+            for (std::size_t i = 0; i + shift <= FecLength; ++i) {
+                lambda[i + shift] ^= field.mul(scale, previous[i]);
+            }
+            if (2 * errorCount <= static_cast<int>(n)) {
+                errorCount = static_cast<int>(n) + 1 - errorCount;
+                std::copy(temp, temp + FecLength + 1, previous);
+                previousDiscrepancy = discrepancy;
+                shift = 1;
+            } else {
+                ++shift;
+            }
+        }
+        if (errorCount > static_cast<int>(FecLength / 2)) {
+            return false;
+        }
+
+        // omega(x) = S(x) * lambda(x) mod x^FecLength
+        uint8_t omega[FecLength] = { 0 };
+        for (std::size_t i = 0; i < FecLength; ++i) {
+            for (std::size_t j = 0; j <= i && j <= static_cast<std::size_t>(errorCount); ++j) {
+                omega[i] ^= field.mul(lambda[j], syndromes[i - j]);
+            }
+        }
+
+        // Chien ֻڴλϽУҵĸ lambda Ĵ
+        int errorPositions[FecLength / 2];
+        int found = 0;
+        for (std::size_t k = 0; k < CodewordLength; ++k) {
+            long long inverseLog = -static_cast<long long>(positionDegree[k]); // X^-1 = alpha^(-deg)
+            if (evaluate(lambda, errorCount, inverseLog) == 0) {
+                if (found == errorCount) {
+                    return false;
+                }
+                errorPositions[found++] = static_cast<int>(k);
+            }
+        }
+        if (found != errorCount) {
+            return false;
+        }
+
+        // Forneye = X^(1 - GeneratorIndex) * omega(X^-1) / lambda'(X^-1)
+        for (int e = 0; e < found; ++e) {
+            int k = errorPositions[e];
+            long long inverseLog = -static_cast<long long>(positionDegree[k]);
+            uint8_t numerator = evaluate(omega, static_cast<int>(FecLength) - 1, inverseLog);
+            uint8_t denominator = 0;
+            for (int i = 1; i <= errorCount; i += 2) { //  2 ʽֻ
+                denominator ^= field.mul(lambda[i], field.alphaPow(inverseLog * (i - 1)));
+            }
+            if (denominator == 0) {
+                return false;
+            }
+            uint8_t magnitude = field.mul(field.div(numerator, denominator),
+                field.alphaPow(static_cast<long long>(positionDegree[k]) * (1 - static_cast<long long>(GeneratorIndex))));
+            codeword[k] ^= magnitude;
+        }
+
+        return !computeSyndromes(codeword, syndromes);
+    }
+
+    //  bits  bitOffset ȡһ֣ payload д payload (ȥĩβ)
+    bool decode(const BitStream& bits, std::size_t bitOffset, std::string& payload) const {
+        payload.clear();
+        if (bits.size() < bitOffset + CodewordLength * 8) {
+            return false;
+        }
+        uint8_t codeword[CodewordLength];
+        for (std::size_t k = 0; k < CodewordLength; ++k) {
+            codeword[k] = bits.byteAt(bitOffset + k * 8);
+        }
+        if (!decode(codeword)) {
+            return false;
+        }
+        std::size_t length = PayloadLength;
+        while (length > 0 && codeword[length - 1] == 0) {
+            --length;
+        }
+        payload.assign(reinterpret_cast<const char*>(codeword), length);
+        return true;
+    }
+
+private:
+    // ȫʽڷʽʱ true
+    bool computeSyndromes(const uint8_t* codeword, uint8_t* syndromes) const {
+        for (std::size_t i = 0; i < FecLength; ++i) {
+            syndromes[i] = 0;
+        }
+        for (std::size_t k = 0; k < CodewordLength; ++k) {
+            if (codeword[k] == 0) continue;
+            int logValue = field.log(codeword[k]);
+            const int* rowLog = syndromeLog[k];
+            // ڲ FecLength ʽ޷֧ڱչ/
+            for (std::size_t i = 0; i < FecLength; ++i) {
+                syndromes[i] ^= field.exp(logValue + rowLog[i]);
+            }
+        }
+        uint8_t any = 0;
+        for (std::size_t i = 0; i < FecLength; ++i) {
+            any |= syndromes[i];
+        }
+        return any != 0;
+    }
+
+    //  poly(alpha^xLog)poly[d] Ϊ x^d ϵ
+    uint8_t evaluate(const uint8_t* poly, int degree, long long xLog) const {
+        uint8_t result = 0;
+        for (int d = degree; d >= 0; --d) {
+            result = field.mul(result, field.alphaPow(xLog)) ^ poly[d];
+        }
+        return result;
+    }
+
+    const GaloisField256& field;
+    int positionDegree[CodewordLength];
+    uint8_t parityRows[PayloadLength][FecLength];
+    int syndromeLog[CodewordLength][FecLength];
+};
+
+// ˮӡʹõ RS(255, 223)ÿִ 8 ֽϢ + 32 ֽУ
+typedef ShortenedRSCodec<255, 223, 8> WatermarkRSCodec;
+
+#endif // SHORTENED_RS_CODEC_H
@@ -0,0 +1,54 @@
+#include "TemporalRegionCache.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+TemporalRegionCache::TemporalRegionCache(double maxMeanAbsDiff, double maxEdgeChange, int thumbnailWidth)
+    : maxMeanAbsDiff(maxMeanAbsDiff), maxEdgeChange(maxEdgeChange), thumbnailWidth(thumbnailWidth),
+      previousEdgeCount(0), currentEdgeCount(0), hitCount(0), missCount(0), acceptedCount(0), rejectedCount(0) {
+    if (maxMeanAbsDiff < 0 || maxEdgeChange < 0 || thumbnailWidth <= 0) {
+        throw std::invalid_argument("TemporalRegionCache: Thresholds must be non-negative and thumbnail width positive.");
+    }
+}
+
+bool TemporalRegionCache::isSameShot(const cv::Mat& image, const EdgeBitmap& edgeBitmap) {
+    if (image.empty() || image.channels() != 1 || image.size() != edgeBitmap.size()) {
+        throw std::invalid_argument("TemporalRegionCache: Image must be single channel and match the edge bitmap.");
+    }
+    int width = std::min(thumbnailWidth, image.cols);
+    int height = std::max(1, static_cast<int>(std::lround(static_cast<double>(image.rows) * width / image.cols)));
+    cv::resize(image, currentThumbnail, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+    currentSize = image.size();
+    currentEdgeCount = edgeBitmap.countAll();
+
+    bool sameShot = false;
+    if (!regions.empty() && previousSize == currentSize && previousThumbnail.size() == currentThumbnail.size()) {
+        double meanAbsDiff = cv::norm(currentThumbnail, previousThumbnail, cv::NORM_L1) / currentThumbnail.total();
+        double edgeChange = std::abs(currentEdgeCount - previousEdgeCount) / std::max(1.0, static_cast<double>(previousEdgeCount));
+        sameShot = meanAbsDiff <= maxMeanAbsDiff && edgeChange <= maxEdgeChange;
+    }
+    if (sameShot) {
+        ++hitCount;
+    } else {
+        ++missCount;
+    }
+    return sameShot;
+}
+
+void TemporalRegionCache::update(const std::vector<Region>& selectedRegions) {
+    std::swap(previousThumbnail, currentThumbnail);
+    previousSize = currentSize;
+    previousEdgeCount = currentEdgeCount;
+    regions = selectedRegions;
+}
+
+void TemporalRegionCache::reset() {
+    previousThumbnail.release();
+    previousSize = cv::Size();
+    previousEdgeCount = 0;
+    regions.clear();
+    hitCount = 0;
+    missCount = 0;
+    acceptedCount = 0;
+    rejectedCount = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef TEMPORAL_REGION_CACHE_H
+#define TEMPORAL_REGION_CACHE_H
+
+#include "EdgeBitmap.h"
+#include "utils.h"
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// Ƶ֡ѡãһ֡ Y ͼԵ (ԵͼժҪ) ѡе
+// ǰ֡ͼһ֡ƽԲԵԱ仯ֵʱΪͬһֹͷ
+// ȡһ֡򸽽ֲϸ (RegionSelector::refineEmbeddingRegions)ϸͶƱıλͨŲ
+// ( RS ) (ͷл) ͼʾܾʱ໨һϸͶλֻھͷʱ侲ֹϻ㡣Ƕ˲ʹãǶֻɱ֡ȡ˲ܲ֡ʷҵǡ
+// ԵⱾִ֡УǶǿɱ֡ԵԤȫ DCT޷ֻھֲ㡣
+class TemporalRegionCache {
+public:
+    TemporalRegionCache(double maxMeanAbsDiff = 3.0, double maxEdgeChange = 0.15, int thumbnailWidth = 64);
+
+    // ǰ֡Ƿһ֡ͬһͷ (ͬʱµǰ֡ժҪ update ʹ)
+    bool isSameShot(const cv::Mat& image, const EdgeBitmap& edgeBitmap);
+
+    // һ֡ѡе
+    const std::vector<Region>& getRegions() const { return regions; }
+
+    // õǰ֡ (һ isSameShot Ĳ) ժҪѡе»
+    void update(const std::vector<Region>& selectedRegions);
+
+    void reset();
+
+    // ¼һʾǷ񱻲
+    void recordHint(bool accepted) { ++(accepted ? acceptedCount : rejectedCount); }
+
+    int getHitCount() const { return hitCount; }
+    int getMissCount() const { return missCount; }
+    int getAcceptedCount() const { return acceptedCount; }
+    int getRejectedCount() const { return rejectedCount; }
+
+private:
+    double maxMeanAbsDiff; // ͼƽԲֵ (0~255)
+    double maxEdgeChange; // ԵԱ仯ֵ
+    int thumbnailWidth;
+
+    cv::Mat previousThumbnail;
+    cv::Mat currentThumbnail;
+    cv::Size previousSize;
+    cv::Size currentSize;
+    int previousEdgeCount;
+    int currentEdgeCount;
+    std::vector<Region> regions;
+    int hitCount;
+    int missCount;
+    int acceptedCount;
+    int rejectedCount;
+};
+
+#endif // TEMPORAL_REGION_CACHE_H
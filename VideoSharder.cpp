@@ -0,0 +1,243 @@
+#include "VideoSharder.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#define popen _popen
+#define pclose _pclose
+#else
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+extern char** environ;
+#endif
+
+VideoSharder::VideoSharder(const std::string& workDirectory)
+    : workDirectory(std::filesystem::absolute(workDirectory).string()) {
+    std::filesystem::create_directories(this->workDirectory);
+}
+
+std::string VideoSharder::captureOutput(const std::string& command) {
+    FILE* pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) {
+        throw std::runtime_error("Failed to run command: " + command);
+    }
+    std::string output;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+        output += buffer;
+    }
+    pclose(pipe);
+    return output;
+}
+
+double VideoSharder::probeDuration(const std::string& videoPath) {
+    std::string output = captureOutput("ffprobe -v error -show_entries format=duration -of default=noprint_wrappers=1:nokey=1 \"" + videoPath + "\"");
+    try {
+        return std::stod(output);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Could not read the duration of " + videoPath);
+    }
+}
+
+int VideoSharder::countFrames(const std::string& videoPath) {
+    std::string output = captureOutput("ffprobe -v error -count_packets -select_streams v:0 -show_entries stream=nb_read_packets -of csv=p=0 \"" + videoPath + "\"");
+    try {
+        return std::stoi(output);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Could not count the frames of " + videoPath);
+    }
+}
+
+void VideoSharder::probeFrameSize(const std::string& videoPath, int& width, int& height) {
+    std::string output = captureOutput("ffprobe -v error -select_streams v:0 -show_entries stream=width,height -of csv=s=x:p=0 \"" + videoPath + "\"");
+    if (sscanf(output.c_str(), "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+        throw std::runtime_error("Could not read the frame size of " + videoPath);
+    }
+}
+
+std::vector<VideoSegment> VideoSharder::split(const std::string& inputVideo, int numShards) {
+    if (numShards <= 0) {
+        throw std::invalid_argument("Number of shards must be positive.");
+    }
+    double duration = probeDuration(inputVideo);
+    double segmentSeconds = duration / numShards;
+
+    // segment ֻڹؼ֡пʵʶ numShards
+    std::string pattern = workDirectory + "/segment_%03d.mp4";
+    char segmentTime[32];
+    snprintf(segmentTime, sizeof(segmentTime), "%.3f", segmentSeconds);
+    std::string splitCommand = "ffmpeg -y -v error -i \"" + inputVideo + "\" -map 0:v:0 -c copy -f segment -segment_time " + segmentTime
+                             + " -reset_timestamps 1 \"" + pattern + "\"";
+    if (system(splitCommand.c_str()) != 0) {
+        throw std::runtime_error("Failed to split " + inputVideo + " into segments.");
+    }
+
+    std::vector<VideoSegment> segments;
+    int nextFrame = 0;
+    for (int index = 0; ; ++index) {
+        char segmentName[32];
+        snprintf(segmentName, sizeof(segmentName), "/segment_%03d.mp4", index);
+        std::string segmentPath = workDirectory + segmentName;
+        if (!std::filesystem::exists(segmentPath)) {
+            break;
+        }
+        VideoSegment segment;
+        segment.path = segmentPath;
+        segment.firstFrame = nextFrame;
+        segment.frameCount = countFrames(segmentPath);
+        nextFrame += segment.frameCount;
+        segments.push_back(segment);
+    }
+    if (segments.empty()) {
+        throw std::runtime_error("Splitting " + inputVideo + " produced no segments.");
+    }
+    return segments;
+}
+
+void VideoSharder::concatenate(const std::vector<std::string>& segmentPaths, const std::string& audioSource, const std::string& outputVideo) {
+    std::string listPath = workDirectory + "/concat_list.txt";
+    std::ofstream list(listPath);
+    for (const std::string& path : segmentPaths) {
+        list << "file '" << std::filesystem::absolute(path).string() << "'\n";
+    }
+    list.close();
+
+    std::string concatCommand = "ffmpeg -y -v error -f concat -safe 0 -i \"" + listPath + "\" -i \"" + audioSource
+                              + "\" -map 0:v -map 1:a? -c copy \"" + outputVideo + "\"";
+    if (system(concatCommand.c_str()) != 0) {
+        throw std::runtime_error("Failed to concatenate segments into " + outputVideo);
+    }
+}
+
+#ifdef _WIN32
+// _spawnvp ѲÿոƴһУӽٰ MSVCRT ֣հ׻ŵĲţ
+// ǰͽβķбܼӱʹӽ̲Ĳԭȫһ
+static std::string quoteWindowsArgument(const std::string& argument) {
+    if (!argument.empty() && argument.find_first_of(" \t\n\v\"") == std::string::npos) {
+        return argument;
+    }
+    std::string quoted = "\"";
+    for (size_t i = 0; ; ++i) {
+        size_t backslashes = 0;
+        while (i < argument.size() && argument[i] == '\\') {
+            ++backslashes;
+            ++i;
+        }
+        if (i == argument.size()) {
+            quoted.append(backslashes * 2, '\\');
+            break;
+        }
+        if (argument[i] == '"') {
+            quoted.append(backslashes * 2 + 1, '\\');
+        } else {
+            quoted.append(backslashes, '\\');
+        }
+        quoted.push_back(argument[i]);
+    }
+    quoted.push_back('"');
+    return quoted;
+}
+
+int VideoSharder::runParallel(const std::vector<std::vector<std::string>>& argvs, bool discardOutput) {
+    // ڼѱ̵ stdout / stderr ʱָ豸ӽ̼̳кٻָ
+    int savedStdout = -1;
+    int savedStderr = -1;
+    if (discardOutput) {
+        fflush(stdout);
+        fflush(stderr);
+        int nullFd = _open("NUL", _O_WRONLY);
+        if (nullFd >= 0) {
+            savedStdout = _dup(1);
+            savedStderr = _dup(2);
+            _dup2(nullFd, 1);
+            _dup2(nullFd, 2);
+            _close(nullFd);
+        }
+    }
+    std::vector<intptr_t> children;
+    int failures = 0;
+    for (const std::vector<std::string>& arguments : argvs) {
+        if (arguments.empty()) {
+            ++failures;
+            continue;
+        }
+        std::vector<std::string> quoted;
+        quoted.reserve(arguments.size());
+        for (const std::string& argument : arguments) {
+            quoted.push_back(quoteWindowsArgument(argument));
+        }
+        std::vector<const char*> childArgv;
+        for (const std::string& argument : quoted) {
+            childArgv.push_back(argument.c_str());
+        }
+        childArgv.push_back(nullptr);
+        intptr_t child = _spawnvp(_P_NOWAIT, arguments[0].c_str(), childArgv.data());
+        if (child == -1) {
+            ++failures;
+        } else {
+            children.push_back(child);
+        }
+    }
+    if (savedStdout >= 0) {
+        _dup2(savedStdout, 1);
+        _dup2(savedStderr, 2);
+        _close(savedStdout);
+        _close(savedStderr);
+    }
+    for (intptr_t child : children) {
+        int exitCode = 0;
+        if (_cwait(&exitCode, child, _WAIT_CHILD) == -1 || exitCode != 0) {
+            ++failures;
+        }
+    }
+    return failures;
+}
+#else
+int VideoSharder::runParallel(const std::vector<std::vector<std::string>>& argvs, bool discardOutput) {
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+    if (discardOutput) {
+        posix_spawn_file_actions_addopen(&fileActions, 1, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_adddup2(&fileActions, 1, 2);
+    }
+    std::vector<pid_t> children;
+    int failures = 0;
+    for (const std::vector<std::string>& arguments : argvs) {
+        if (arguments.empty()) {
+            ++failures;
+            continue;
+        }
+        std::vector<char*> childArgv;
+        for (const std::string& argument : arguments) {
+            childArgv.push_back(const_cast<char*>(argument.c_str()));
+        }
+        childArgv.push_back(nullptr);
+        pid_t child = 0;
+        if (posix_spawnp(&child, childArgv[0], &fileActions, nullptr, childArgv.data(), environ) != 0) {
+            ++failures;
+        } else {
+            children.push_back(child);
+        }
+    }
+    posix_spawn_file_actions_destroy(&fileActions);
+    for (pid_t child : children) {
+        int status = 0;
+        pid_t waited;
+        do {
+            waited = waitpid(child, &status, 0);
+        } while (waited == -1 && errno == EINTR);
+        if (waited == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            ++failures;
+        }
+    }
+    return failures;
+}
+#endif
@@ -0,0 +1,46 @@
+#ifndef VIDEO_SHARDER_H
+#define VIDEO_SHARDER_H
+
+#include <string>
+#include <vector>
+
+// ƵֶΣڹؼ֡ƵпνĹ̴ƴ
+struct VideoSegment {
+    std::string path; // ֶļ
+    int firstFrame = 0; // öεһ֡Ƶе֡ ( 0 ʼ)
+    int frameCount = 0; // öε֡
+};
+
+class VideoSharder {
+public:
+    // workDirectory ŷֶļƴб (ʱ)
+    explicit VideoSharder(const std::string& workDirectory);
+
+    //  inputVideo Ƶ (±롢Ƶ) ڹؼ֡гԼ numShards Σ
+    // ͳ֡õÿεȫʼ֡ (αÿ N ֡Ƕ / ȡĵһ)
+    std::vector<VideoSegment> split(const std::string& inputVideo, int numShards);
+
+    // ˳ƴӸƵӻ audioSource Ƶ (ûƵʱ)
+    void concatenate(const std::vector<std::string>& segmentPaths, const std::string& audioSource, const std::string& outputVideo);
+
+    // ÿһӽִ̲ (argv[0] Ϊ򣬰 PATH )ȫ󷵻ʧ (޷˳ 0) 
+    // ԭӽ̡ shellˮӡı·еšֺŵȲᱻͣ
+    // discardOutput Ϊ true ʱӽ̵ı׼ͱ׼ض򵽿豸
+    static int runParallel(const std::vector<std::vector<std::string>>& argvs, bool discardOutput = false);
+
+    // Ƶʱ () Ƶ֡ ()
+    static double probeDuration(const std::string& videoPath);
+    static int countFrames(const std::string& videoPath);
+    // һƵĿ (ȡʧʱ׳ std::runtime_error)
+    static void probeFrameSize(const std::string& videoPath, int& width, int& height);
+
+    const std::string& getWorkDirectory() const { return workDirectory; }
+
+private:
+    std::string workDirectory;
+
+    // ִ׼
+    static std::string captureOutput(const std::string& command);
+};
+
+#endif // VIDEO_SHARDER_H
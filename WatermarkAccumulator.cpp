@@ -0,0 +1,78 @@
+#include "WatermarkAccumulator.h"
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+WatermarkAccumulator::WatermarkAccumulator(int watermarkLength, Mode mode, double minConfidence)
+    : watermarkDecoder(),
+      accumulationMode(mode),
+      minimumConfidence(minConfidence),
+      expectedWatermarkLength(watermarkLength),
+      frameCount(0),
+      regionObservationCount(0),
+      lastDecodeSucceeded(false),
+      accumulatedVotes(watermarkLength, 0.0)
+{
+    if (watermarkLength <= 0) {
+        throw std::invalid_argument("Watermark length must be positive.");
+    }
+    if (minConfidence < 0.0 || minConfidence > 1.0) {
+        throw std::invalid_argument("Minimum confidence must be between 0.0 and 1.0.");
+    }
+}
+
+void WatermarkAccumulator::addFrame(const std::vector<BitStream>& hardBits, const std::vector<std::vector<double>>& softBits) {
+    if (hardBits.size() != softBits.size()) {
+        throw std::invalid_argument("WatermarkAccumulator: Hard and soft bit region counts mismatch.");
+    }
+
+    for (size_t r = 0; r < hardBits.size(); ++r) {
+        if (hardBits[r].size() != static_cast<size_t>(expectedWatermarkLength) || softBits[r].size() != static_cast<size_t>(expectedWatermarkLength)) {
+            throw std::invalid_argument("WatermarkAccumulator: Extracted bit count does not match watermark length.");
+        }
+        for (int i = 0; i < expectedWatermarkLength; ++i) {
+            if (accumulationMode == Mode::Soft) {
+                accumulatedVotes[i] += softBits[r][i];
+            } else {
+                accumulatedVotes[i] += (hardBits[r][i] == 1) ? 1.0 : -1.0;
+            }
+        }
+        regionObservationCount++;
+    }
+    frameCount++;
+    lastDecodeSucceeded = false;
+}
+
+bool WatermarkAccumulator::tryDecode(std::string& decodedText) {
+    decodedText.clear();
+    if (regionObservationCount == 0) {
+        lastDecodeSucceeded = false;
+        return false;
+    }
+
+    // 뵥֡ͶƱһ£ƽƱΪ 1
+    BitStream finalBits(expectedWatermarkLength, 0);
+    for (int i = 0; i < expectedWatermarkLength; ++i) {
+        finalBits.set(i, accumulatedVotes[i] >= 0.0 ? 1 : 0);
+    }
+
+    lastDecodeSucceeded = watermarkDecoder.tryDecodeWatermark(finalBits, decodedText);
+    return lastDecodeSucceeded;
+}
+
+double WatermarkAccumulator::getConfidence() const {
+    if (regionObservationCount == 0) return 0.0;
+
+    double sum = 0.0;
+    for (double vote : accumulatedVotes) {
+        sum += std::abs(vote);
+    }
+    return sum / (static_cast<double>(expectedWatermarkLength) * regionObservationCount);
+}
+
+void WatermarkAccumulator::reset() {
+    std::fill(accumulatedVotes.begin(), accumulatedVotes.end(), 0.0);
+    frameCount = 0;
+    regionObservationCount = 0;
+    lastDecodeSucceeded = false;
+}
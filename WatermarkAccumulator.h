@@ -0,0 +1,46 @@
+#ifndef WATERMARK_ACCUMULATOR_H
+#define WATERMARK_ACCUMULATOR_H
+
+#include "WatermarkDecoder.h"
+#include <string>
+#include <vector>
+
+// ֡ۻ RS ǰɺˮӡ֡ıͶƱۼ
+class WatermarkAccumulator {
+public:
+    enum class Mode {
+        Hard, // ÿÿλͶ +1/-1 Ʊ
+        Soft  // ÿÿλۼоֵ [-1, 1]
+    };
+
+    // 캯ˮӡ mۻʽǰСŶ (0~1)
+    WatermarkAccumulator(int watermarkLength, Mode mode = Mode::Soft, double minConfidence = 0.2);
+
+    // ۼһ֡ȡ ( WatermarkExtractor::extractRegionBits)
+    void addFrame(const std::vector<BitStream>& hardBits, const std::vector<std::vector<double>>& softBits);
+
+    // õǰۻһоԽ룬λ RS ͨʱ true
+    bool tryDecode(std::string& decodedText);
+
+    // ǰۻŶȣÿλ |ۻֵ| / ۻ ľֵ
+    double getConfidence() const;
+
+    // ǷǰһνɹŶȴﵽֵ
+    bool isConfident() const { return lastDecodeSucceeded && getConfidence() >= minimumConfidence; }
+
+    int getFrameCount() const { return frameCount; }
+
+    void reset();
+
+private:
+    WatermarkDecoder watermarkDecoder;
+    Mode accumulationMode;
+    double minimumConfidence;
+    int expectedWatermarkLength; // m
+    int frameCount;
+    int regionObservationCount; // ۻ (֡ x ÿ֡)
+    bool lastDecodeSucceeded;
+    std::vector<double> accumulatedVotes; // ֵ 1ֵ 0
+};
+
+#endif // WATERMARK_ACCUMULATOR_H
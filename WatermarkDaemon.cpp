@@ -0,0 +1,280 @@
+#include "WatermarkDaemon.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// ӳ÷ڴ (POSIX shm_open / Windows ļӳ)ʱӳ
+class SharedFrameMapping {
+public:
+    SharedFrameMapping(const std::string& name, size_t size) : data(nullptr), size(size) {
+#ifdef _WIN32
+        mappingHandle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+        if (mappingHandle == nullptr) {
+            throw std::invalid_argument("Could not open shared memory: " + name);
+        }
+        data = MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (data == nullptr) {
+            CloseHandle(mappingHandle);
+            throw std::invalid_argument("Could not map shared memory: " + name);
+        }
+#else
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            throw std::invalid_argument("Could not open shared memory: " + name);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < size) {
+            close(fd);
+            throw std::invalid_argument("Shared memory is smaller than the frame: " + name);
+        }
+        void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            throw std::invalid_argument("Could not map shared memory: " + name);
+        }
+        data = mapped;
+#endif
+    }
+
+    ~SharedFrameMapping() {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(mappingHandle);
+#else
+        munmap(data, size);
+#endif
+    }
+
+    SharedFrameMapping(const SharedFrameMapping&) = delete;
+    SharedFrameMapping& operator=(const SharedFrameMapping&) = delete;
+
+    void* get() const { return data; }
+
+private:
+    void* data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE mappingHandle;
+#endif
+};
+
+std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, '\t')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+// ظֶвַָܳ
+std::string sanitizeField(std::string text) {
+    for (char& c : text) {
+        if (c == '\t' || c == '\n' || c == '\r') {
+            c = ' ';
+        }
+    }
+    return text;
+}
+
+const char* statusName(WatermarkStatus status) {
+    switch (status) {
+    case WatermarkStatus::Ok: return "OK";
+    case WatermarkStatus::NotFound: return "NOT_FOUND";
+    case WatermarkStatus::InvalidInput: return "INVALID";
+    default: return "FAILED";
+    }
+}
+
+std::string formatEmbedReply(const EmbedResult& result) {
+    std::ostringstream reply;
+    reply << statusName(result.status) << '\t';
+    if (result.status == WatermarkStatus::Ok) {
+        reply << result.timings.totalMs;
+    } else {
+        reply << sanitizeField(result.message);
+    }
+    return reply.str();
+}
+
+std::string formatExtractReply(const ExtractResult& result) {
+    std::ostringstream reply;
+    reply << statusName(result.status) << '\t';
+    if (result.status == WatermarkStatus::Ok) {
+        reply << sanitizeField(result.text) << '\t' << result.confidence << '\t' << result.timings.totalMs;
+    } else {
+        reply << sanitizeField(result.message);
+    }
+    return reply.str();
+}
+
+cv::Size parseFrameSize(const std::string& width, const std::string& height) {
+    int w = std::stoi(width);
+    int h = std::stoi(height);
+    if (w <= 0 || h <= 0) {
+        throw std::invalid_argument("Frame width and height must be positive.");
+    }
+    return cv::Size(w, h);
+}
+}
+
+WatermarkDaemon::WatermarkDaemon(const std::string& socketPath, int numWorkers, const WatermarkProfile& profile, const std::string& cacheDirectory)
+    : socketPath(socketPath), service(numWorkers, profile, true, cacheDirectory),
+      stopping(false), requestCount(0), activeConnections(0) {
+}
+
+WatermarkDaemon::~WatermarkDaemon() {
+    stop();
+    std::unique_lock<std::mutex> lock(connectionMutex);
+    connectionsClosed.wait(lock, [this]() { return activeConnections == 0; });
+}
+
+void WatermarkDaemon::run() {
+    {
+        // ȸֵټ stoppingstop() λ stopping ټ shutdown⽻©ֹͣ
+        LocalSocket socket = LocalSocket::listen(socketPath);
+        std::lock_guard<std::mutex> lock(listenerMutex);
+        listener = std::move(socket);
+    }
+    int consecutiveFailures = 0;
+    while (!stopping) {
+        LocalSocket connection = listener.accept(); // accept  shutdown ֻȡҪ
+        if (!connection.isValid()) {
+            if (stopping) {
+                break;
+            }
+            // źŴϵʱļľ (EMFILE) ȳʱ˱ܣתռ CPU
+            ++consecutiveFailures;
+            int backoffMs = std::min(1000, 10 << std::min(consecutiveFailures - 1, 7));
+            std::unique_lock<std::mutex> lock(listenerMutex);
+            stopRequested.wait_for(lock, std::chrono::milliseconds(backoffMs), [this]() { return stopping.load(); });
+            continue;
+        }
+        consecutiveFailures = 0;
+        {
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            ++activeConnections;
+        }
+        // ߳н run() ŷ
+        std::thread(&WatermarkDaemon::serveConnection, this, std::move(connection)).detach();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(connectionMutex);
+        for (LocalSocket* connection : connections) {
+            connection->shutdown();
+        }
+        connectionsClosed.wait(lock, [this]() { return activeConnections == 0; });
+    }
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex);
+        listener.close();
+    }
+    std::error_code ignored;
+    std::filesystem::remove(socketPath, ignored);
+}
+
+void WatermarkDaemon::stop() {
+    if (stopping.exchange(true)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex);
+        listener.shutdown(); //  accept ϵ run()
+        stopRequested.notify_all();
+    }
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    for (LocalSocket* connection : connections) {
+        connection->shutdown();
+    }
+}
+
+void WatermarkDaemon::serveConnection(LocalSocket connection) {
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        connections.insert(&connection);
+        if (stopping) {
+            connection.shutdown();
+        }
+    }
+    std::string requestLine;
+    while (connection.readLine(requestLine)) {
+        if (requestLine.empty()) {
+            continue;
+        }
+        if (!connection.writeLine(handleRequest(requestLine))) {
+            break;
+        }
+        if (requestLine == "SHUTDOWN") {
+            stop();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        connections.erase(&connection);
+        connection.close();
+        --activeConnections;
+        connectionsClosed.notify_all(); // ֪ͨȴ () ǰ֪ͨ
+    }
+}
+
+std::string WatermarkDaemon::handleRequest(const std::string& requestLine) {
+    ++requestCount;
+    std::vector<std::string> fields = splitFields(requestLine);
+    if (fields.empty()) {
+        return "ERROR\tEmpty request";
+    }
+    const std::string& command = fields[0];
+    try {
+        if (command == "PING") {
+            return "OK\tpong";
+        }
+        if (command == "STATS") {
+            std::ostringstream reply;
+            reply << "OK\t" << requestCount.load() << '\t' << service.getWorkerCount() << '\t' << service.getPendingCount();
+            return reply.str();
+        }
+        if (command == "SHUTDOWN") {
+            return "OK"; // ߳дظٵ stop()
+        }
+        if (command == "EMBED" && fields.size() == 4) {
+            return formatEmbedReply(service.embedFileAsync(fields[1], fields[2], fields[3]).get());
+        }
+        if (command == "EXTRACT" && fields.size() == 2) {
+            return formatExtractReply(service.extractFileAsync(fields[1]).get());
+        }
+        if (command == "EMBED_SHM" && fields.size() == 5) {
+            cv::Size frameSize = parseFrameSize(fields[2], fields[3]);
+            SharedFrameMapping mapping(fields[1], static_cast<size_t>(frameSize.area()) * 3);
+            cv::Mat frame(frameSize, CV_8UC3, mapping.get());
+            EmbedResult result = service.embedAsync(frame, fields[4]).get();
+            if (result.status == WatermarkStatus::Ok) {
+                result.image.copyTo(frame);
+            }
+            return formatEmbedReply(result);
+        }
+        if (command == "EXTRACT_SHM" && fields.size() == 4) {
+            cv::Size frameSize = parseFrameSize(fields[2], fields[3]);
+            SharedFrameMapping mapping(fields[1], static_cast<size_t>(frameSize.area()) * 3);
+            cv::Mat frame(frameSize, CV_8UC3, mapping.get());
+            return formatExtractReply(service.extractAsync(frame).get());
+        }
+        return "ERROR\tUnknown command or wrong number of fields: " + sanitizeField(command);
+    } catch (const std::exception& e) {
+        return std::string("INVALID\t") + sanitizeField(e.what());
+    }
+}
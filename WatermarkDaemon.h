@@ -0,0 +1,63 @@
+#ifndef WATERMARK_DAEMON_H
+#define WATERMARK_DAEMON_H
+
+#include "AsyncWatermarkService.h"
+#include "LocalSocket.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+
+// פˮӡ Unix ׽ϽǶ / ȡʡȥÿεõĽOpenCV ʼ RS 졣
+// ÿһ̰߳˳ʵʼ㽻 AsyncWatermarkService Ĺ߳ (ԤȵǶ / ȡ뻺)
+// ӵ󲢷ִС
+//
+// Э飺ÿһУֶ Tab ָÿظһУֶΪ OK / NOT_FOUND / INVALID / FAILED / ERROR
+//   PING                                         -> OK  pong
+//   EMBED        <input> <output> <text>         -> OK  <total_ms>
+//   EXTRACT      <input>                         -> OK  <text> <confidence> <total_ms>
+//   EMBED_SHM    <shm_name> <width> <height> <text> -> ͵Ƕ빲ڴе BGR24 ֡OK <total_ms>
+//   EXTRACT_SHM  <shm_name> <width> <height>     -> ͬ EXTRACT
+//   STATS                                        -> OK  <requests> <workers> <pending>
+//   SHUTDOWN                                     -> OK  (ֹͣ)
+//
+// ģͣе·͹ڴػ̵ݴ򿪣ӵĿͻ˼ӵػ̵ļдȨ
+// (Ҳܹرշ)׽ļȨΪ 0600ֻػ̵ûӣҪԱȿͻ˸ߵȨУ
+// ׽ַû޷дĿ¼ (˿ȴͬ׽ð)
+class WatermarkDaemon {
+public:
+    WatermarkDaemon(const std::string& socketPath, int numWorkers = 0, const WatermarkProfile& profile = WatermarkProfile(),
+                    const std::string& cacheDirectory = "");
+    ~WatermarkDaemon();
+
+    // ʼУֱյ SHUTDOWN  stop()ǰȴӽ
+    void run();
+    // ɴ̵߳
+    void stop();
+
+    // һ󲢷ػظ (з)
+    std::string handleRequest(const std::string& requestLine);
+
+    size_t getRequestCount() const { return requestCount.load(); }
+    int getWorkerCount() const { return service.getWorkerCount(); }
+
+private:
+    std::string socketPath;
+    AsyncWatermarkService service;
+    LocalSocket listener; //  listenerMutex  (run() ֵ͹رգstop() ߳ shutdown)
+    std::mutex listenerMutex;
+    std::condition_variable stopRequested; //  accept ʧܺ˱ܵȴе run()
+    std::atomic<bool> stopping;
+    std::atomic<size_t> requestCount;
+
+    //  (stop() ʱرԻڶȡϵ߳)
+    std::mutex connectionMutex;
+    std::condition_variable connectionsClosed;
+    std::set<LocalSocket*> connections;
+    int activeConnections;
+
+    void serveConnection(LocalSocket connection);
+};
+
+#endif // WATERMARK_DAEMON_H
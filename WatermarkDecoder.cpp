@@ -1,12 +1,6 @@
 #include "WatermarkDecoder.h"
+#include "utils.h"
 #include <stdexcept>
-#include "schifra_galois_field.hpp"
-#include "schifra_galois_field_polynomial.hpp"
-#include "schifra_sequential_root_generator_polynomial_creator.hpp"
-#include "schifra_reed_solomon_encoder.hpp"
-#include "schifra_reed_solomon_decoder.hpp"
-#include "schifra_reed_solomon_block.hpp"
-#include "schifra_error_processes.hpp"
 #include <iostream>
 #include <numeric>
 #include <sstream>
@@ -19,103 +13,74 @@ WatermarkDecoder::WatermarkDecoder(int rsN, int rsK, int markerLength, double ma
     if (markerThreshold < 0.0 || markerThreshold > 1.0) {
         throw std::invalid_argument("Marker threshold must be between 0.0 and 1.0.");
     }
-    // ʵӦУʼ RS 
+    // RS ڱڹ̶ (WatermarkRSCodec)
+    if (rs_n != 255 || rs_k != 223) {
+        throw std::invalid_argument("Only RS(255, 223) is supported.");
+    }
 }
 
 // λȷ (λȫ 1)
-bool WatermarkDecoder::checkMarkerBits(const std::vector<int>& bits) {
+bool WatermarkDecoder::checkMarkerBits(const BitStream& bits) {
     if (bits.size() < marker_len) {
-        std::cerr << "Error: Extracted bits are shorter than marker length." << std::endl;
+        libraryWarning() << "Error: Extracted bits are shorter than marker length." << std::endl;
         return false; // Լ
     }
 
-    int correctCount = 0;
-    for (int i = bits.size() - marker_len; i < bits.size(); ++i) {
-        if (bits[i] != 1) { // Ƕʱλ 1
-            correctCount++;
-        }
-    }
+    // Ƕʱλ 1 popcount ͳƷ 1 ıλ
+    int correctCount = marker_len - static_cast<int>(bits.countOnes(bits.size() - marker_len, marker_len));
 
     double correctRate = static_cast<double>(correctCount) / marker_len;
-    std::cout << "Marker bit correct rate: " << correctRate * 100 << "%" << std::endl;
+    libraryLog() << "Marker bit correct rate: " << correctRate * 100 << "%" << std::endl;
     return correctRate <= marker_correct_threshold;
 }
 
 // ִ RS  (ռλ)
 std::string WatermarkDecoder::performRSDecoding(const std::string& data) {
-    constexpr std::size_t field_descriptor = 8;
-    constexpr std::size_t generator_polynomial_index = 120;
-    constexpr std::size_t generator_polynomial_root_count = 32;
-
-    constexpr std::size_t code_length = 255;
-    constexpr std::size_t fec_length = 32;
-    constexpr std::size_t data_length = 223;
-
-    // 1. ٤
-    const schifra::galois::field field(
-        field_descriptor,
-        schifra::galois::primitive_polynomial_size06,
-        schifra::galois::primitive_polynomial06
-    );
-
-    // 2. ɶʽ
-    schifra::galois::field_polynomial generator_polynomial(field);
-    if (!schifra::make_sequential_root_generator_polynomial(
-        field,
-        generator_polynomial_index,
-        generator_polynomial_root_count,
-        generator_polynomial)) {
-        std::cerr << "Error - Failed to create sequential root generator!" << std::endl;
-        std::cerr << "return raw data" << std::endl;
+    bool success = false;
+    return performRSDecoding(data, success);
+}
+
+// ִ RS 룬ͨ success Ƿɹ
+std::string WatermarkDecoder::performRSDecoding(const std::string& data, bool& success) {
+    success = false;
+    if (data.size() < WatermarkRSCodec::CodewordLength) {
+        libraryWarning() << "Error - Codeword is shorter than " << WatermarkRSCodec::CodewordLength << " bytes!" << std::endl;
         return data;
     }
 
-    // 3. 
-    typedef schifra::reed_solomon::decoder<code_length, fec_length, data_length> decoder_t;
-    const decoder_t decoder(field, generator_polynomial_index);
-
-
-    std::string temp = data.substr(0, 8).append(std::string(215, '\0'));
-    // 5. RS
-    schifra::reed_solomon::block<code_length, fec_length> block(temp, data.substr(8, 40));
+    // ֲ: ǰ PayloadLength ֽΪϢ FecLength ֽΪУ (ֵ̲Ĳ㲻)
+    uint8_t codeword[WatermarkRSCodec::CodewordLength];
+    for (std::size_t k = 0; k < WatermarkRSCodec::CodewordLength; ++k) {
+        codeword[k] = static_cast<uint8_t>(data[k]);
+    }
 
-    // 6. 
-    if (!decoder.decode(block)){
-        std::cout << "Error - Critical decoding failure!" << std::endl;
+    if (!rsCodec.decode(codeword)) {
+        libraryLog() << "Error - Critical decoding failure!" << std::endl;
         return data;
     }
 
-    std::string decodeword;
-    decodeword.resize(data_length);
-
-    block.data_to_string(decodeword);
+    // ȥϢĩβĲ
+    std::size_t length = WatermarkRSCodec::PayloadSize;
+    while (length > 0 && codeword[length - 1] == 0) {
+        --length;
+    }
 
-    return decodeword;
+    success = true;
+    return std::string(reinterpret_cast<const char*>(codeword), length);
 }
 
 // λתΪַ (ÿ 8 bits תһ char)
-std::string WatermarkDecoder::bitsToString(const std::vector<int>& bits) {
-    std::string text = "";
-    int n = bits.size();
+std::string WatermarkDecoder::bitsToString(const BitStream& bits) {
+    size_t n = bits.size();
     if (n % 8 != 0) {
-        std::cerr << "Warning: Decoded bit count (" << n << ") is not a multiple of 8. String conversion might be incorrect." << std::endl;
+        libraryWarning() << "Warning: Decoded bit count (" << n << ") is not a multiple of 8. String conversion might be incorrect." << std::endl;
     }
-
-    for (int i = 0; i < n / 8; ++i) {
-        char c = 0;
-        for (int j = 0; j < 8; ++j) {
-            if (bits[i * 8 + j] == 1) {
-                c |= (1 << (7 - j));
-            }
-        }
-        text += c;
-    }
-    return text;
+    return bits.toBytes();
 }
 
 
 // ȡı (Ӧ Step 4)
-std::string WatermarkDecoder::decodeWatermark(std::vector<int>& extractedBits) {
+std::string WatermarkDecoder::decodeWatermark(BitStream& extractedBits) {
     if (extractedBits.empty()) {
         throw std::runtime_error("No bits extracted to decode.");
     }
@@ -138,9 +103,30 @@ std::string WatermarkDecoder::decodeWatermark(std::vector<int>& extractedBits) {
     std::string decodedData = performRSDecoding(originalWatermark);
     if (decodedData.empty()) {
          //  RS ʧܻûλ
-         std::cerr << "Warning: RS decoding resulted in empty data bits." << std::endl;
+         libraryWarning() << "Warning: RS decoding resulted in empty data bits." << std::endl;
          return "";
     }
 
     return decodedData;
 }
+
+// Խ (ڶ֡ۻʱ֡)
+bool WatermarkDecoder::tryDecodeWatermark(const BitStream& extractedBits, std::string& decodedText) {
+    decodedText.clear();
+    if (extractedBits.size() <= static_cast<size_t>(marker_len)) {
+        return false;
+    }
+    if (!checkMarkerBits(extractedBits)) {
+        return false;
+    }
+
+    // ֱӴӱȡ֣⿽ֱд decodedText (õ÷)
+    if (extractedBits.size() - marker_len < WatermarkRSCodec::CodewordLength * 8) {
+        return false;
+    }
+    if (!rsCodec.decode(extractedBits, 0, decodedText) || decodedText.empty()) {
+        decodedText.clear();
+        return false;
+    }
+    return true;
+}
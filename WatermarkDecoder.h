@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <string>
+#include "BitStream.h"
+#include "ShortenedRSCodec.h"
 
 class WatermarkDecoder {
 public:
@@ -11,22 +13,27 @@ public:
 
     // ȡı (Ӧ Step 4)
     // ؽԭʼˮӡı
-    std::string decodeWatermark(std::vector<int>& extractedBits);
+    std::string decodeWatermark(BitStream& extractedBits);
+
+    // Խ룬쳣λ RS ͨʱ true
+    bool tryDecodeWatermark(const BitStream& extractedBits, std::string& decodedText);
+
+    // ֻĩβλȷ ( RS )۵жһǷ׼Ƕλ
+    bool checkMarkerBits(const BitStream& bits);
 
 private:
     int rs_n; // RS ܳ
     int rs_k; // RS Ϣλ
     int marker_len; // Ϣ
     double marker_correct_threshold; // λֵ ( 0.2)
+    WatermarkRSCodec rsCodec; // ػ RS(255, 223) 
 
-    // ڲλȷ
-    bool checkMarkerBits(const std::vector<int>& bits);
-
-    // ڲִ RS  (˴Ϊʾ⣬ʵҪ RS )
+    // ڲִ RS  (ΪϢ + Уֽ)
     std::string performRSDecoding(const std::string& data);
+    std::string performRSDecoding(const std::string& data, bool& success);
 
     // ڲλתΪַ
-    std::string bitsToString(const std::vector<int>& bits);
+    std::string bitsToString(const BitStream& bits);
 };
 
 #endif // WATERMARK_DECODER_H
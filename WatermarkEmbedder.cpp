@@ -1,84 +1,196 @@
 #include "WatermarkEmbedder.h"
+#include <chrono>
 #include <stdexcept>
 #include <iostream>
 #include "utils.h"
 
-WatermarkEmbedder::WatermarkEmbedder(int numRegions, int edgeThreshold)
-    : edgeDetector(), // ʹĬϲض
+namespace {
+WatermarkProfile profileWithScales(int edgeThreshold, double windowScale, double stepScale) {
+    WatermarkProfile profile;
+    profile.edgeThreshold = edgeThreshold;
+    profile.windowScale = windowScale;
+    profile.stepScale = stepScale;
+    return profile;
+}
+}
+
+WatermarkEmbedder::WatermarkEmbedder(int numRegions, int edgeThreshold, double windowScale, double stepScale)
+    : WatermarkEmbedder(profileWithScales(edgeThreshold, windowScale, stepScale), numRegions)
+{}
+
+WatermarkEmbedder::WatermarkEmbedder(const WatermarkProfile& profile, int numRegions)
+    : edgeDetector(profile.cannyLow, profile.cannyHigh, profile.postProcessThreshold),
       regionScorer(), // ʹĬȨػضȨ
-      regionSelector(regionScorer, numRegions), //  scorer Ŀ
+      regionSelector(regionScorer, numRegions, profile.windowScale, profile.stepScale), //  scorerĿͻ
       watermarkEncoder(), // ʹĬϲ
-      blockProcessor(edgeThreshold), // Եֵ Th
+      blockProcessor(profile.edgeThreshold, profile.gaussianSigma), // Եֵ Th ˹׼
       numberOfRegions(numRegions)
 {}
 
 cv::Mat WatermarkEmbedder::embedWatermark(const cv::Mat& originalImage, const std::string& watermarkText) {
+    cv::Mat finalWatermarkedImage;
+    embedWatermark(originalImage, watermarkText, finalWatermarkedImage);
+    return finalWatermarkedImage;
+}
+
+void WatermarkEmbedder::embedWatermark(const cv::Mat& originalImage, const std::string& watermarkText, cv::Mat& outputImage) {
+    if (watermarkText.empty()) {
+        throw std::invalid_argument("Watermark text cannot be empty.");
+    }
+
+    libraryLog() << "Starting watermark embedding..." << std::endl;
+    analyze(originalImage, frameAnalysis);
+    embed(frameAnalysis, watermarkText, outputImage);
+    libraryLog() << "Watermark embedding complete." << std::endl;
+}
+
+void WatermarkEmbedder::embedWatermarkInPlace(cv::Mat& image, const std::string& watermarkText) {
+    if (watermarkText.empty()) {
+        throw std::invalid_argument("Watermark text cannot be empty.");
+    }
+    if (image.empty() || image.type() != CV_8UC1) {
+        throw std::invalid_argument("In-place embedding requires a non-empty CV_8UC1 image (Y channel).");
+    }
+
+    libraryLog() << "Starting in-place watermark embedding..." << std::endl;
+    // ֱõ÷أ޸ǰ DC ڷãÿֻһȶд
+    frameAnalysis.originalImage = image;
+    try {
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+        analyzeImage(frameAnalysis);
+        Clock::time_point analyzed = Clock::now();
+        writeBlocks(frameAnalysis, encodeCached(watermarkText), image);
+        lastAnalysisMs = std::chrono::duration<double, std::milli>(analyzed - start).count();
+        lastEmbedMs = std::chrono::duration<double, std::milli>(Clock::now() - analyzed).count();
+    } catch (...) {
+        frameAnalysis.originalImage.release();
+        throw;
+    }
+    frameAnalysis.originalImage.release(); // е÷
+    libraryLog() << "Watermark embedding complete." << std::endl;
+}
+
+void WatermarkEmbedder::embedWatermarkInPlace(uint8_t* yPlane, int width, int height, size_t stride, const std::string& watermarkText) {
+    if (yPlane == nullptr || width <= 0 || height <= 0 || stride < static_cast<size_t>(width)) {
+        throw std::invalid_argument("Invalid Y plane buffer, size or stride.");
+    }
+    cv::Mat image(height, width, CV_8UC1, yPlane, stride); // ֻͼ
+    embedWatermarkInPlace(image, watermarkText);
+}
+
+EmbeddingAnalysis WatermarkEmbedder::analyze(const cv::Mat& originalImage) {
+    EmbeddingAnalysis analysis;
+    analyze(originalImage, analysis);
+    return analysis;
+}
+
+void WatermarkEmbedder::analyze(const cv::Mat& originalImage, EmbeddingAnalysis& analysis) {
     if (originalImage.empty()) {
         throw std::invalid_argument("Input image is empty.");
     }
     if (originalImage.channels() != 1) {
         throw std::invalid_argument("Input image must be single channel (Y channel).");
     }
-    if (watermarkText.empty()) {
-        throw std::invalid_argument("Watermark text cannot be empty.");
-    }
 
-    std::cout << "Starting watermark embedding..." << std::endl;
+    // ԭͼ÷֮Ƿ޸ͼ
+    originalImage.copyTo(analysis.originalImage);
+    analyzeImage(analysis);
+}
+
+void WatermarkEmbedder::analyzeImage(EmbeddingAnalysis& analysis) {
+    const cv::Mat& image = analysis.originalImage;
 
     // Step 1: Ե
-    std::cout << "Step 1: Detecting edges..." << std::endl;
-    cv::Mat edgeImage = edgeDetector.detectEdges(originalImage);
-    std::cout << "Edge detection complete." << std::endl;
+    libraryLog() << "Step 1: Detecting edges..." << std::endl;
+    const EdgeBitmap& edgeBitmap = edgeDetector.detectEdgeBitmap(image, workspace);
+    analysis.edgePixelCount = edgeBitmap.countAll();
+    libraryLog() << "Edge detection complete." << std::endl;
 
     // Step 2: ÷֣ѡ4ߵ÷
-    std::cout << "Step 2: Selecting top 4 embedding regions..." << std::endl;
+    libraryLog() << "Step 2: Selecting top 4 embedding regions..." << std::endl;
     RegionSelector regionSelectorForEmbedding(regionScorer, 4, regionSelector.getWindowScale(), regionSelector.getStepScale());
-    std::vector<Region> selectedRegions = regionSelectorForEmbedding.selectEmbeddingRegions(originalImage, edgeImage);
-    if (selectedRegions.size() < 4) {
+    // Ƕÿ֡ͼֻɱ֡ȡ˲֡ʷҵͬ
+    regionSelectorForEmbedding.selectEmbeddingRegions(image, edgeBitmap, workspace, analysis.regions);
+    if (analysis.regions.size() < 4) {
+        analysis.regions.clear();
         throw std::runtime_error("Failed to select 4 embedding regions.");
     }
-    std::cout << "Selected " << selectedRegions.size() << " regions for embedding." << std::endl;
+    analysis.regions.resize(4);
+    libraryLog() << "Selected " << analysis.regions.size() << " regions for embedding." << std::endl;
 
-    // Step 3: ˮӡ
-    std::cout << "Step 3: Encoding watermark..." << std::endl;
-    std::vector<int> watermarkBits = watermarkEncoder.encodeWatermark(watermarkText);
-    int watermarkLength = watermarkBits.size();
-    std::cout << "Watermark encoded into " << watermarkLength << " bits." << std::endl;
-    if (watermarkLength <= 0) {
-        throw std::runtime_error("Encoded watermark has zero length.");
+    // ֳm (m Ϊˮӡȣˮӡ޹)
+    analysis.watermarkLength = watermarkEncoder.getEncodedLength();
+    analysis.regionBlocks.resize(analysis.regions.size());
+    for (size_t regionIdx = 0; regionIdx < analysis.regions.size(); ++regionIdx) {
+        const Region& region = analysis.regions[regionIdx];
+        blockProcessor.prepareBlocks(image(region.bounds), edgeBitmap, region.bounds, analysis.watermarkLength, workspace, analysis.regionBlocks[regionIdx]);
     }
+}
 
-    // Step 4: ÿǶˮӡֳm飬ÿǶ1λ
-    cv::Mat watermarkedImage = originalImage.clone();
-    watermarkedImage.convertTo(watermarkedImage, CV_64F);
+cv::Mat WatermarkEmbedder::embed(const EmbeddingAnalysis& analysis, const std::string& watermarkText) {
+    cv::Mat outputImage;
+    embed(analysis, watermarkText, outputImage);
+    return outputImage;
+}
 
-    for (int regionIdx = 0; regionIdx < 4; ++regionIdx) {
-        const Region& region = selectedRegions[regionIdx];
-        cv::Mat regionPatch = originalImage(region.bounds);
-        cv::Mat regionEdgePatch = edgeImage(region.bounds);
+void WatermarkEmbedder::embed(const EmbeddingAnalysis& analysis, const std::string& watermarkText, cv::Mat& outputImage) {
+    if (analysis.empty()) {
+        throw std::invalid_argument("Embedding analysis is empty.");
+    }
+    if (watermarkText.empty()) {
+        throw std::invalid_argument("Watermark text cannot be empty.");
+    }
 
-        // ֳm
-        std::vector<ImageBlock> blocks = blockProcessor.prepareBlocks(regionPatch, regionEdgePatch, watermarkLength);
+    // Step 3: ˮӡ
+    libraryLog() << "Step 3: Encoding watermark..." << std::endl;
+    const BitStream& watermarkBits = encodeCached(watermarkText);
+    libraryLog() << "Watermark encoded into " << watermarkBits.size() << " bits." << std::endl;
 
-        for (int i = 0; i < watermarkLength; ++i) {
-            const ImageBlock& block = blocks[i];
-            int watermarkBit = watermarkBits[i];
+    // Step 4: ز䣬ֱдԭֵ޸ 8 λ
+    analysis.originalImage.copyTo(outputImage);
+    writeBlocks(analysis, watermarkBits, outputImage);
+}
 
-            cv::Mat blockPatch = regionPatch(block.bounds);
-            cv::Mat modificationMatrix = blockProcessor.calculatePixelModifications(block, blockPatch, watermarkBit);
+void WatermarkEmbedder::writeBlocks(const EmbeddingAnalysis& analysis, const BitStream& watermarkBits, cv::Mat& target) {
+    int watermarkLength = watermarkBits.size();
+    if (watermarkLength != analysis.watermarkLength) {
+        throw std::runtime_error("Encoded watermark length does not match the analysis.");
+    }
 
-            // Ӧ޸
-            cv::Mat targetPatch = watermarkedImage(region.bounds)(block.bounds);
-            cv::Mat modificationMatrixFloat;
-            modificationMatrix.convertTo(modificationMatrixFloat, CV_64F);
-            cv::add(targetPatch, modificationMatrixFloat, targetPatch);
+    // ÿǶˮӡֳm飬ÿǶ1λ
+    const cv::Mat& originalImage = analysis.originalImage;
+    // 򻥲صڵĿ黥ཻ   УÿֻдԼĿ飬봮һ
+    int regionCount = static_cast<int>(analysis.regions.size());
+    cv::parallel_for_(cv::Range(0, regionCount * watermarkLength), [&](const cv::Range& range) {
+        for (int task = range.start; task < range.end; ++task) {
+            int regionIdx = task / watermarkLength;
+            int i = task % watermarkLength;
+            const cv::Rect& regionBounds = analysis.regions[regionIdx].bounds;
+            const ImageBlock& block = analysis.regionBlocks[regionIdx][i];
+            cv::Rect blockBounds = block.bounds + regionBounds.tl();
+            cv::Mat targetPatch = target(blockBounds);
+            blockProcessor.writeModifiedBlock(block, originalImage(blockBounds), watermarkBits[i], targetPatch);
         }
-    }
+    });
+}
 
-    // ת8λ
-    cv::Mat finalWatermarkedImage;
-    watermarkedImage.convertTo(finalWatermarkedImage, CV_8U);
+void WatermarkEmbedder::buildVariantBank(const EmbeddingAnalysis& analysis, BlockVariantBank& bank) {
+    bank.build(analysis, blockProcessor);
+}
 
-    std::cout << "Watermark embedding complete." << std::endl;
-    return finalWatermarkedImage;
+void WatermarkEmbedder::embed(const BlockVariantBank& bank, const std::string& watermarkText, cv::Mat& outputImage) {
+    if (watermarkText.empty()) {
+        throw std::invalid_argument("Watermark text cannot be empty.");
+    }
+    bank.assemble(encodeCached(watermarkText), outputImage);
+}
+
+// ˮӡ (ͬһıһεı)
+const BitStream& WatermarkEmbedder::encodeCached(const std::string& watermarkText) {
+    if (cachedWatermarkBits.empty() || watermarkText != cachedWatermarkText) {
+        cachedWatermarkBits = watermarkEncoder.encodeWatermark(watermarkText);
+        cachedWatermarkText = watermarkText;
+    }
+    return cachedWatermarkBits;
 }
@@ -5,19 +5,77 @@
 #include "RegionSelector.h"
 #include "WatermarkEncoder.h"
 #include "BlockProcessor.h"
+#include "FrameWorkspace.h"
+#include "BlockVariantBank.h"
+#include "WatermarkProfile.h"
 #include "utils.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <opencv2/opencv.hpp>
 
+// ˮӡ޹صķ (Ե⡢ѡ񡢿黮)
+// ͬһͼǶͬˮӡʱֻһΣÿˮӡֻͿ޸
+struct EmbeddingAnalysis {
+    cv::Mat originalImage; // ԭʼ Y ͨ (CV_8Uʱ޸ͼӰ)
+    std::vector<Region> regions; // ѡеǶ
+    std::vector<std::vector<ImageBlock>> regionBlocks; // ÿĿ鲼 (߽򣬺ǿȡȨԭʼ DC)
+    int watermarkLength = 0; // ÿĿ = ˮӡλ
+    int edgePixelCount = 0; // ԵͼеıԵ (ժҪϢ)
+
+    bool empty() const { return regions.empty(); }
+};
+
 class WatermarkEmbedder {
 public:
     // 캯ʼ
-    WatermarkEmbedder(int numRegions = 10, int edgeThreshold = 3); // ʾ
+    // windowScale / stepScale ΪѡĻ벽 (ȡʹֵͬ)
+    WatermarkEmbedder(int numRegions = 10, int edgeThreshold = 3, double windowScale = 0.25, double stepScale = 0.25); // ʾ
+
+    // ļĲ (Ե⡢ѡ鴦ȫȡ profile)
+    explicit WatermarkEmbedder(const WatermarkProfile& profile, int numRegions = 4);
 
     // ִˮӡǶ
     cv::Mat embedWatermark(const cv::Mat& originalImage, const std::string& watermarkText);
 
+    // ͬϣд÷е outputImage (CV_8Uߴ粻ʱڴ)
+    // ֱͬ֡ʱем仺ڲ workspaceԤȺ·
+    // (OpenCV ڲʱڴ⣬ FrameWorkspace)
+    void embedWatermark(const cv::Mat& originalImage, const std::string& watermarkText, cv::Mat& outputImage);
+
+    // ͵Ƕ룺ֱ޸ĵ÷е Y ƽ (CV_8UC1 ROI װⲿĴ stride ͼ)
+    // ֡ͼֻд޸Ŀأлĸͬ
+    void embedWatermarkInPlace(cv::Mat& image, const std::string& watermarkText);
+
+    // ͬϣyPlane ΪⲿеĻstride Ϊмֽ
+    void embedWatermarkInPlace(uint8_t* yPlane, int width, int height, size_t stride, const std::string& watermarkText);
+
+    // ͼ (Step 1, 2 黮)ɶˮӡظʹ
+    EmbeddingAnalysis analyze(const cv::Mat& originalImage);
+
+    // ͬϣд analysis ()
+    void analyze(const cv::Mat& originalImage, EmbeddingAnalysis& analysis);
+
+    // ѷͼǶˮӡ (Step 3 ֮)ֻͿ޸
+    // analysis ֻɱ̸߳ԵǶ
+    cv::Mat embed(const EmbeddingAnalysis& analysis, const std::string& watermarkText);
+
+    // ͬϣд÷е outputImage (ߴ粻ʱڴ)
+    void embed(const EmbeddingAnalysis& analysis, const std::string& watermarkText, cv::Mat& outputImage);
+
+    // ݷԤÿǶ 0 / 1 ֱ (Ƕͬˮӡʱʹ)
+    void buildVariantBank(const EmbeddingAnalysis& analysis, BlockVariantBank& bank);
+
+    // ñװˮӡͼֻͰλ embed(analysis, ...) һ
+    void embed(const BlockVariantBank& bank, const std::string& watermarkText, cv::Mat& outputImage);
+
+    // ڲصķ (δд)
+    size_t getWorkspaceAllocationCount() const { return workspace.getAllocationCount(); }
+
+    // һξ͵Ƕķֽ׶κʱ () (Ե⡢ѡ񡢿黮) д
+    double getLastAnalysisMs() const { return lastAnalysisMs; }
+    double getLastEmbedMs() const { return lastEmbedMs; }
+
 private:
     EdgeDetector edgeDetector;
     RegionScorer regionScorer; // RegionSelector ڲõ
@@ -26,6 +84,22 @@ private:
     BlockProcessor blockProcessor;
 
     int numberOfRegions; // d
+
+    FrameWorkspace workspace; // ֡õʱ
+    EmbeddingAnalysis frameAnalysis; // embedWatermark ֡õķ
+    std::string cachedWatermarkText; // һαˮӡı
+    BitStream cachedWatermarkBits; // һα (ͬһıظ RS )
+    double lastAnalysisMs = 0.0;
+    double lastEmbedMs = 0.0;
+
+    // ˮӡ (ͬһıһεı)
+    const BitStream& encodeCached(const std::string& watermarkText);
+
+    //  analysis.originalImage ɷ (analyze ȿ룬͵Ƕֱõ÷ͼ)
+    void analyzeImage(EmbeddingAnalysis& analysis);
+
+    // ˮӡλ޸ĸĿ飺 analysis.originalImage Ŀأд target ͬһλ (߿ͬһͼ)
+    void writeBlocks(const EmbeddingAnalysis& analysis, const BitStream& watermarkBits, cv::Mat& target);
 };
 
 #endif // WATERMARK_EMBEDDER_H
@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <string>
+#include "BitStream.h"
+#include "ShortenedRSCodec.h"
 
 class WatermarkEncoder {
 public:
@@ -10,22 +12,21 @@ public:
     WatermarkEncoder(int rsN = 255, int rsK = 223, int markerLength = 41); // ʾ RS(255, 223)
 
     // ˮӡ (Ӧ Step 3)
-    // ضˮӡ (0  1)
-    std::vector<int> encodeWatermark(const std::string& originalWatermark);
+    // ذλѹĶˮӡ
+    BitStream encodeWatermark(const std::string& originalWatermark);
+
+    // ˮӡ (λ)ˮӡ޹
+    int getEncodedLength() const { return static_cast<int>(WatermarkRSCodec::CodewordLength * 8) + marker_len; }
 
 private:
     int rs_n; // RS ܳ
     int rs_k; // RS Ϣλ
     int marker_len; // Ϣ
 
-    // ڲӱϢ
-    std::vector<int> addMarkerBits(const std::vector<int>& data);
-
-    // ڲִ RS  (˴Ϊʾ⣬ʵҪ RS )
-    std::string performRSEncoding(const std::string& data);
+    WatermarkRSCodec rsCodec; //  RS(255, 223) 
 
-    // ڲַתΪλ
-    std::vector<int> stringToBits(const std::string& text);
+    // ڲڱĩβӱϢ
+    void addMarkerBits(BitStream& data);
 };
 
 #endif // WATERMARK_ENCODER_H
@@ -3,20 +3,99 @@
 #include <iostream>
 #include <cmath>
 
-WatermarkExtractor::WatermarkExtractor(int expectedWatermarkLength, int edgeThreshold)
-    : edgeDetector(),
+namespace {
+WatermarkProfile profileWithScales(int edgeThreshold, double windowScale, double stepScale) {
+    WatermarkProfile profile;
+    profile.edgeThreshold = edgeThreshold;
+    profile.windowScale = windowScale;
+    profile.stepScale = stepScale;
+    return profile;
+}
+
+uint64_t quantize(double value) {
+    return static_cast<uint64_t>(value * 1e6);
+}
+}
+
+WatermarkExtractor::WatermarkExtractor(int expectedWatermarkLength, int edgeThreshold, double windowScale, double stepScale)
+    : WatermarkExtractor(expectedWatermarkLength, profileWithScales(edgeThreshold, windowScale, stepScale))
+{}
+
+WatermarkExtractor::WatermarkExtractor(int expectedWatermarkLength, const WatermarkProfile& profile)
+    : edgeDetector(profile.cannyLow, profile.cannyHigh, profile.postProcessThreshold),
       regionScorer(),
-      regionSelector(regionScorer, expectedWatermarkLength),
-      blockProcessor(edgeThreshold),
+      regionSelector(regionScorer, expectedWatermarkLength, profile.windowScale, profile.stepScale),
+      blockProcessor(profile.edgeThreshold, profile.gaussianSigma),
+      gridSynchronizer(blockProcessor, 0),
       watermarkDecoder(),
-      expectedWatermarkLength(expectedWatermarkLength)
+      expectedWatermarkLength(expectedWatermarkLength),
+      baseParameterHash(0),
+      cancelFlag(nullptr),
+      temporalReuse(false)
 {
     if (expectedWatermarkLength <= 0) {
         throw std::invalid_argument("Expected watermark length must be positive.");
     }
+    // ӰȡĲ (Ե⡢ѡ黮) 汾һ
+    baseParameterHash = AnalysisCache::combine(baseParameterHash, 2);
+    baseParameterHash = AnalysisCache::combine(baseParameterHash, static_cast<uint64_t>(expectedWatermarkLength));
+    baseParameterHash = AnalysisCache::combine(baseParameterHash, static_cast<uint64_t>(profile.edgeThreshold));
+    baseParameterHash = AnalysisCache::combine(baseParameterHash, quantize(profile.windowScale));
+    baseParameterHash = AnalysisCache::combine(baseParameterHash, quantize(profile.stepScale));
+    baseParameterHash = AnalysisCache::combine(baseParameterHash, quantize(profile.cannyLow));
+    baseParameterHash = AnalysisCache::combine(baseParameterHash, quantize(profile.cannyHigh));
+    baseParameterHash = AnalysisCache::combine(baseParameterHash, quantize(profile.postProcessThreshold));
+}
+
+void WatermarkExtractor::setAnalysisCache(const std::string& directory) {
+    analysisCache = AnalysisCache(directory);
+}
+
+void WatermarkExtractor::setTemporalRegionReuse(bool enabled) {
+    temporalReuse = enabled;
+    temporalRegions.reset();
+}
+
+void WatermarkExtractor::setGridResync(int searchRadius) {
+    gridSynchronizer.setSearchRadius(searchRadius);
+}
+
+uint64_t WatermarkExtractor::cacheSeed() const {
+    // ͬıȡʱѵǰ뾶 (ֻȡǰ״̬õʷ޹)
+    int searchRadius = gridSynchronizer.getSearchRadius();
+    if (searchRadius <= 0) {
+        return baseParameterHash;
+    }
+    return AnalysisCache::combine(AnalysisCache::combine(baseParameterHash, 0x52535943), static_cast<uint64_t>(searchRadius));
 }
 
 std::string WatermarkExtractor::extractWatermark(const cv::Mat& watermarkedImage) {
+    extractRegionBits(watermarkedImage, regionBits, regionSoftBits);
+    return decodeRegionBits();
+}
+
+std::string WatermarkExtractor::decodeRegionBits() {
+    std::vector<BitStream>& allExtractedBits = regionBits;
+
+    // Step 3: 4ȡͶƱõձ
+    BitStream::atLeast(allExtractedBits, 2, votedBits); // ͶƱ (ֲ)
+
+    libraryLog() << "Extraction of " << votedBits.size() << " bits complete." << std::endl;
+
+    libraryLog() << "Step 4: Decoding extracted bits..." << std::endl;
+    std::string decodedWatermark;
+    try {
+        decodedWatermark = watermarkDecoder.decodeWatermark(votedBits);
+        libraryLog() << "Decoding complete." << std::endl;
+    } catch (const std::exception& e) {
+        libraryWarning() << "Error during decoding: " << e.what() << std::endl;
+        return "";
+    }
+
+    return decodedWatermark;
+}
+
+void WatermarkExtractor::extractRegionBits(const cv::Mat& watermarkedImage, std::vector<BitStream>& hardBits, std::vector<std::vector<double>>& softBits) {
     if (watermarkedImage.empty()) {
         throw std::invalid_argument("Input watermarked image is empty.");
     }
@@ -24,34 +103,147 @@ std::string WatermarkExtractor::extractWatermark(const cv::Mat& watermarkedImage
         throw std::invalid_argument("Input watermarked image must be single channel (Y channel).");
     }
 
-    std::cout << "Starting watermark extraction..." << std::endl;
+    libraryLog() << "Starting watermark extraction..." << std::endl;
+
+    // д̻ʱֱӷػо
+    // ֡临ʱѡ֮ǰ֡йأֻͼݾд
+    bool useCache = analysisCache.enabled() && !temporalReuse;
+    uint64_t cacheKey = 0;
+    if (useCache) {
+        cacheKey = AnalysisCache::hashImage(watermarkedImage, cacheSeed());
+        if (analysisCache.load(cacheKey, watermarkedImage.size(), 4, expectedWatermarkLength, cacheEntry)) {
+            libraryLog() << "Analysis cache hit." << std::endl;
+            hardBits = cacheEntry.hardBits;
+            softBits = cacheEntry.softBits;
+            return;
+        }
+    }
 
     // Step 1: ÷֣ѡ4ߵ÷
-    std::cout << "Step 1: Detecting edges and selecting regions..." << std::endl;
-    cv::Mat edgeImage = edgeDetector.detectEdges(watermarkedImage);
+    libraryLog() << "Step 1: Detecting edges and selecting regions..." << std::endl;
+    const EdgeBitmap& edgeBitmap = edgeDetector.detectEdgeBitmap(watermarkedImage, workspace);
+    if (!extractRegionBitsWithEdges(watermarkedImage, edgeBitmap, hardBits, softBits)) {
+        throw std::runtime_error("Extraction was cancelled.");
+    }
+
+    if (useCache) {
+        cacheEntry.hardBits = hardBits;
+        cacheEntry.softBits = softBits;
+        analysisCache.store(cacheKey, watermarkedImage.size(), cacheEntry);
+    }
+}
+
+bool WatermarkExtractor::tryExtract(const cv::Mat& watermarkedImage, std::string& decodedText, double& confidence) {
+    decodedText.clear();
+    confidence = 0.0;
+    try {
+        extractRegionBits(watermarkedImage, regionBits, regionSoftBits);
+    } catch (const std::exception& e) {
+        libraryWarning() << "Warning: Extraction attempt failed: " << e.what() << std::endl;
+        return false;
+    }
+    double confidenceSum = 0.0;
+    size_t softBitCount = 0;
+    for (const std::vector<double>& softBits : regionSoftBits) {
+        for (double softBit : softBits) {
+            confidenceSum += std::abs(softBit);
+        }
+        softBitCount += softBits.size();
+    }
+    confidence = softBitCount > 0 ? confidenceSum / softBitCount : 0.0;
+    BitStream::atLeast(regionBits, 2, votedBits);
+    return watermarkDecoder.tryDecodeWatermark(votedBits, decodedText);
+}
+
+bool WatermarkExtractor::tryExtractWithEdges(const cv::Mat& image, const EdgeBitmap& edgeBitmap, std::string& decodedText) {
+    decodedText.clear();
+    if (image.empty() || image.channels() != 1 || image.size() != edgeBitmap.size()) {
+        return false;
+    }
+    try {
+        if (!extractRegionBitsWithEdges(image, edgeBitmap, regionBits, regionSoftBits)) {
+            return false;
+        }
+    } catch (const std::exception& e) {
+        libraryWarning() << "Warning: Extraction attempt failed: " << e.what() << std::endl;
+        return false;
+    }
+    BitStream::atLeast(regionBits, 2, votedBits);
+    return watermarkDecoder.tryDecodeWatermark(votedBits, decodedText);
+}
+
+bool WatermarkExtractor::extractRegionBitsWithEdges(const cv::Mat& watermarkedImage, const EdgeBitmap& edgeBitmap, std::vector<BitStream>& hardBits, std::vector<std::vector<double>>& softBits) {
+    if (isCancelled()) {
+        return false;
+    }
     RegionSelector regionSelectorForExtraction(regionScorer, 4, regionSelector.getWindowScale(), regionSelector.getStepScale());
-    std::vector<Region> selectedRegions = regionSelectorForExtraction.selectEmbeddingRegions(watermarkedImage, edgeImage);
+    std::vector<Region>& selectedRegions = workspace.selectedRegions();
+    if (temporalReuse && temporalRegions.isSameShot(watermarkedImage, edgeBitmap)) {
+        // һ֡ͬһͷһ֡򸽽ľֲϸֻʾ (ֲŲһǶ˵ͼѡ)
+        // ֻͶƱıλ ( RS )δ׼ʱλӽͨǼ飬صͼ
+        regionSelectorForExtraction.refineEmbeddingRegions(watermarkedImage, edgeBitmap, workspace, temporalRegions.getRegions(), 1, selectedRegions);
+        if (selectedRegions.size() >= 4) {
+            if (!readRegionBits(watermarkedImage, edgeBitmap, selectedRegions, hardBits, softBits)) {
+                return false;
+            }
+            BitStream::atLeast(hardBits, 2, votedBits);
+            bool accepted = watermarkDecoder.checkMarkerBits(votedBits);
+            temporalRegions.recordHint(accepted);
+            if (accepted) {
+                temporalRegions.update(selectedRegions);
+                libraryLog() << "Same shot as previous frame: previous regions pass the marker check." << std::endl;
+                return true;
+            }
+            libraryLog() << "Same shot as previous frame, but previous regions fail the marker check; searching the whole frame." << std::endl;
+        }
+    }
+    regionSelectorForExtraction.selectEmbeddingRegions(watermarkedImage, edgeBitmap, workspace, selectedRegions);
+    if (temporalReuse) {
+        temporalRegions.update(selectedRegions);
+    }
     if (selectedRegions.size() < 4) {
         throw std::runtime_error("Failed to select 4 regions for extraction.");
     }
-    std::cout << "Selected " << selectedRegions.size() << " regions." << std::endl;
+    libraryLog() << "Selected " << selectedRegions.size() << " regions." << std::endl;
+    return readRegionBits(watermarkedImage, edgeBitmap, selectedRegions, hardBits, softBits);
+}
+
+bool WatermarkExtractor::readRegionBits(const cv::Mat& watermarkedImage, const EdgeBitmap& edgeBitmap, const std::vector<Region>& regions, std::vector<BitStream>& hardBits, std::vector<std::vector<double>>& softBits) {
+    // ͬÿƽƵ DC еλ (Ķ֡仺汣δƽƵ)
+    cv::Rect regionBounds[4];
+    for (int regionIdx = 0; regionIdx < 4; ++regionIdx) {
+        regionBounds[regionIdx] = regions[regionIdx].bounds;
+        if (gridSynchronizer.getSearchRadius() > 0) {
+            GridAlignment alignment = gridSynchronizer.align(watermarkedImage, edgeBitmap, regionBounds[regionIdx], expectedWatermarkLength, workspace);
+            if (isLibraryLogEnabled()) {
+                libraryLog() << "Region " << regionIdx << " grid offset (" << alignment.offset.x << ", " << alignment.offset.y
+                          << "), alignment score " << alignment.score << " (unshifted " << alignment.zeroOffsetScore << ")" << std::endl;
+            }
+            regionBounds[regionIdx] += alignment.offset;
+        }
+    }
 
     // Step 2: ÿȡˮӡֳm飬ÿȡ1λ
-    std::vector<std::vector<int>> allExtractedBits(4);
-    cv::Mat watermarkedImageFloat;
-    watermarkedImage.convertTo(watermarkedImageFloat, CV_64F);
+    hardBits.resize(4);
+    softBits.resize(4);
 
     for (int regionIdx = 0; regionIdx < 4; ++regionIdx) {
-        const Region& region = selectedRegions[regionIdx];
-        cv::Mat regionPatch = watermarkedImage(region.bounds);
-        cv::Mat regionEdgePatch = edgeImage(region.bounds);
+        if (isCancelled()) {
+            return false;
+        }
+        const cv::Rect& bounds = regionBounds[regionIdx];
+        cv::Mat regionPatch = watermarkedImage(bounds);
 
         // ֳm
         int m = expectedWatermarkLength;
-        std::vector<ImageBlock> blocks = blockProcessor.prepareBlocks(regionPatch, regionEdgePatch, m);
+        std::vector<ImageBlock>& blocks = workspace.blocks();
+        blockProcessor.prepareBlocks(regionPatch, edgeBitmap, bounds, m, workspace, blocks);
 
-        std::vector<int> extractedBits;
-        extractedBits.reserve(m);
+        BitStream& extractedBits = hardBits[regionIdx];
+        std::vector<double>& extractedSoftBits = softBits[regionIdx];
+        extractedBits.clear();
+        extractedBits.resize(m, 0);
+        extractedSoftBits.clear();
 
         for (int i = 0; i < m; ++i) {
             const ImageBlock& block = blocks[i];
@@ -60,51 +252,31 @@ std::string WatermarkExtractor::extractWatermark(const cv::Mat& watermarkedImage
             double sigma_xy = block.embeddingStrength;
 
             if (sigma_xy <= 0 || blockWidth <= 0 || blockHeight <= 0) {
-                extractedBits.push_back(0);
+                extractedSoftBits.push_back(0.0);
                 continue;
             }
 
-            cv::Mat blockPatchFloat = watermarkedImageFloat(region.bounds)(block.bounds);
-            double dcCoefficient = blockProcessor.calculateDCCoefficient(blockPatchFloat);
+            // DC ϵ prepareBlocks а鲢
+            double dcCoefficient = block.dcCoefficient;
 
             double ab_sqrt = std::sqrt(static_cast<double>(blockWidth * blockHeight));
             double quantizationStep = sigma_xy * ab_sqrt;
 
             if (quantizationStep < 1e-9) {
-                extractedBits.push_back(0);
+                extractedSoftBits.push_back(0.0);
                 continue;
             }
 
             double normalizedDC = dcCoefficient / quantizationStep;
-            int floorValue = static_cast<int>(std::floor(normalizedDC));
+            double floorDC = std::floor(normalizedDC);
+            int floorValue = static_cast<int>(floorDC);
             int extractedBit = std::abs(floorValue % 2);
 
-            extractedBits.push_back(extractedBit);
-        }
-        allExtractedBits[regionIdx] = extractedBits;
-    }
-
-    // Step 3: 4ȡͶƱõձ
-    std::vector<int> finalBits(expectedWatermarkLength, 0);
-    for (int i = 0; i < expectedWatermarkLength; ++i) {
-        int sum = 0;
-        for (int r = 0; r < 4; ++r) {
-            sum += allExtractedBits[r][i];
+            // Ƕʱ DC е (floor + 0.5)еԽоԽɿ
+            double confidence = 1.0 - 2.0 * std::abs(normalizedDC - floorDC - 0.5);
+            extractedBits.set(i, extractedBit);
+            extractedSoftBits.push_back(extractedBit == 1 ? confidence : -confidence);
         }
-        finalBits[i] = (sum >= 2) ? 1 : 0; // ͶƱ
     }
-
-    std::cout << "Extraction of " << finalBits.size() << " bits complete." << std::endl;
-
-    std::cout << "Step 4: Decoding extracted bits..." << std::endl;
-    std::string decodedWatermark;
-    try {
-        decodedWatermark = watermarkDecoder.decodeWatermark(finalBits);
-        std::cout << "Decoding complete." << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Error during decoding: " << e.what() << std::endl;
-        return "";
-    }
-
-    return decodedWatermark;
+    return true;
 }
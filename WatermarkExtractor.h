@@ -4,8 +4,14 @@
 #include "EdgeDetector.h"
 #include "RegionSelector.h"
 #include "BlockProcessor.h"
+#include "BlockGridSynchronizer.h"
+#include "TemporalRegionCache.h"
+#include "FrameWorkspace.h"
 #include "WatermarkDecoder.h" // 
+#include "AnalysisCache.h"
+#include "WatermarkProfile.h"
 #include "utils.h"
+#include <atomic>
 #include <string>
 #include <vector>
 #include <opencv2/opencv.hpp>
@@ -13,19 +19,84 @@
 class WatermarkExtractor {
 public:
     // 캯Ҫԭʼͼ·
-    WatermarkExtractor(int expectedWatermarkLength, int edgeThreshold = 25);
+    // windowScale / stepScale ΪѡĻ벽 (Ƕʱһ)
+    WatermarkExtractor(int expectedWatermarkLength, int edgeThreshold = 25, double windowScale = 0.25, double stepScale = 0.25);
+
+    // ļĲ (Ƕʱһ)
+    WatermarkExtractor(int expectedWatermarkLength, const WatermarkProfile& profile);
 
     // ִˮӡȡ
     std::string extractWatermark(const cv::Mat& watermarkedImage);
 
+    // ȡ 4 ÿһλӲо (λѹ) оֵͶƱͽ
+    // оֵΧ [-1, 1]űʾ (Ϊ 1)ֵʾ DC ƫо߽ĳ̶
+    // hardBits / softBits ڶεü临
+    void extractRegionBits(const cv::Mat& watermarkedImage, std::vector<BitStream>& hardBits, std::vector<std::vector<double>>& softBits);
+
+    int getExpectedWatermarkLength() const { return expectedWatermarkLength; }
+
+    // ṹȡ쳣λ RS ͨʱ true
+    // confidence Ϊ 4 ȫоֵľֵ (0~1ԽоԽɿ)ȡʧʱΪ 0
+    bool tryExtract(const cv::Mat& watermarkedImage, std::string& decodedText, double& confidence);
+
+    // ʹõ÷õıԵͼ (뱾ȡͬ EdgeDetector ͬһͼϵõĬϲ) ȡԽ
+    // λ RS ͨʱ true쳣ȡʱ false
+    bool tryExtractWithEdges(const cv::Mat& image, const EdgeBitmap& edgeBitmap, std::string& decodedText);
+
+    // ȡ־־λtryExtractWithEdges һ׶α߽紦 (nullptr ʾȡ)
+    void setCancellationFlag(const std::atomic<bool>* flag) { cancelFlag = flag; }
+
+    // ô̷ (directory Ϊ)
+    // ʱ extractRegionBits ֱӷػеӲ / оԵ⡢ѡͿ鴦
+    // (֡ѡʱʹû)
+    void setAnalysisCache(const std::string& directory);
+
+    // ÿͬ (searchRadius Ϊ 0 )ѡÿΧ searchRadius 
+    //  FFT ҳƫƣڸƫƴȡ (ڱüƽ˼صͼ)
+    void setGridResync(int searchRadius);
+
+    // ֡ѡ (Ƶ)һ֡ͬһͷʱһ֡򸽽ϸ
+    // ϸȡλܽŲã (ͷл) ͼ֡ͼһ
+    void setTemporalRegionReuse(bool enabled);
+    const TemporalRegionCache& getTemporalRegionCache() const { return temporalRegions; }
+
+    // ڲصķ (δд)
+    size_t getWorkspaceAllocationCount() const { return workspace.getAllocationCount(); }
+
 private:
     EdgeDetector edgeDetector;
     RegionScorer regionScorer; // RegionSelector ڲõ
     RegionSelector regionSelector;
     BlockProcessor blockProcessor;
+    BlockGridSynchronizer gridSynchronizer; // ͬ (ĬϽ)
     WatermarkDecoder watermarkDecoder; // ʵ
 
     int expectedWatermarkLength; // m
+    uint64_t baseParameterHash; // ӰȡĲֵĹϣ
+
+    AnalysisCache analysisCache; // ̷ (ĬϽ)
+    AnalysisCache::Entry cacheEntry; // дʱõļ¼
+    const std::atomic<bool>* cancelFlag; // 貢ȡʱȡ־
+    bool temporalReuse; // Ƿ֡ѡ
+    TemporalRegionCache temporalRegions;
+
+    // ӣbaseParameterHash 뵱ǰͬ뾶
+    uint64_t cacheSeed() const;
+
+    bool isCancelled() const { return cancelFlag != nullptr && cancelFlag->load(std::memory_order_relaxed); }
+
+    // ڸԵͼѡоȡʱ false
+    bool extractRegionBitsWithEdges(const cv::Mat& watermarkedImage, const EdgeBitmap& edgeBitmap, std::vector<BitStream>& hardBits, std::vector<std::vector<double>>& softBits);
+    //  4 о (ͬʱȶ񣬲Ķ)
+    bool readRegionBits(const cv::Mat& watermarkedImage, const EdgeBitmap& edgeBitmap, const std::vector<Region>& regions, std::vector<BitStream>& hardBits, std::vector<std::vector<double>>& softBits);
+
+    //  regionBits  (Step 3, 4)
+    std::string decodeRegionBits();
+
+    FrameWorkspace workspace; // ֡õʱ
+    std::vector<BitStream> regionBits; // extractWatermark ʹõӲо
+    BitStream votedBits; //  (֡)
+    std::vector<std::vector<double>> regionSoftBits; // extractWatermark ʹõо
 };
 
 #endif // WATERMARK_EXTRACTOR_H
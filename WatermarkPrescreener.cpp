@@ -0,0 +1,119 @@
+#include "WatermarkPrescreener.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+WatermarkProfile profileWithEdgeThreshold(int edgeThreshold) {
+    WatermarkProfile profile;
+    profile.edgeThreshold = edgeThreshold;
+    return profile;
+}
+}
+
+WatermarkPrescreener::WatermarkPrescreener(int expectedWatermarkLength, int edgeThreshold, int scale,
+                                           double positiveThreshold, double negativeThreshold, int markerLength)
+    : WatermarkPrescreener(profileWithEdgeThreshold(edgeThreshold), expectedWatermarkLength, scale,
+                           positiveThreshold, negativeThreshold, markerLength)
+{}
+
+WatermarkPrescreener::WatermarkPrescreener(const WatermarkProfile& profile, int expectedWatermarkLength, int scale,
+                                           double positiveThreshold, double negativeThreshold, int markerLength)
+    : edgeDetector(profile.cannyLow, profile.cannyHigh, profile.postProcessThreshold),
+      regionScorer(),
+      regionSelector(regionScorer, 4, profile.windowScale, profile.stepScale),
+      // ԵԼԵȳȣС scale ͬСֵ
+      reducedBlockProcessor(profile.edgeThreshold / std::max(scale, 1), profile.gaussianSigma),
+      fullBlockProcessor(profile.edgeThreshold, profile.gaussianSigma),
+      watermarkDecoder(255, 223, markerLength),
+      expectedWatermarkLength(expectedWatermarkLength),
+      scaleFactor(scale),
+      positiveConfidence(positiveThreshold),
+      negativeConfidence(negativeThreshold),
+      markerLen(markerLength)
+{
+    if (scale != 1 && scale != 2 && scale != 4 && scale != 8) {
+        throw std::invalid_argument("WatermarkPrescreener: Scale must be 1, 2, 4 or 8.");
+    }
+    if (negativeThreshold > positiveThreshold) {
+        throw std::invalid_argument("WatermarkPrescreener: Negative threshold cannot exceed positive threshold.");
+    }
+    if (markerLength <= 0 || markerLength >= expectedWatermarkLength) {
+        throw std::invalid_argument("WatermarkPrescreener: Marker length must be in (0, watermark length).");
+    }
+}
+
+PrescreenResult WatermarkPrescreener::prescreen(const std::string& imagePath) {
+    int flags = cv::IMREAD_GRAYSCALE;
+    switch (scaleFactor) {
+        case 2: flags = cv::IMREAD_REDUCED_GRAYSCALE_2; break;
+        case 4: flags = cv::IMREAD_REDUCED_GRAYSCALE_4; break;
+        case 8: flags = cv::IMREAD_REDUCED_GRAYSCALE_8; break;
+        default: break;
+    }
+    cv::Mat reducedImage = cv::imread(imagePath, flags);
+    if (reducedImage.empty()) {
+        throw std::runtime_error("Could not load image: " + imagePath);
+    }
+    return prescreen(reducedImage);
+}
+
+PrescreenResult WatermarkPrescreener::prescreen(const cv::Mat& reducedImage) {
+    if (reducedImage.empty() || reducedImage.channels() != 1) {
+        throw std::invalid_argument("Prescreen image must be a non-empty single channel image.");
+    }
+
+    PrescreenResult result;
+
+    // ѡСͼϽ (ںͲͼߴıȷֱ޹)
+    const EdgeBitmap& edgeBitmap = edgeDetector.detectEdgeBitmap(reducedImage, workspace);
+    std::vector<Region>& selectedRegions = workspace.selectedRegions();
+    regionSelector.selectEmbeddingRegions(reducedImage, edgeBitmap, workspace, selectedRegions);
+    if (selectedRegions.size() < 4) {
+        // ͼС޷Ԥɸȡж
+        return result;
+    }
+
+    // ÿоֵ / sigma ż (R_DC / (sigma * sqrt(ab)) = ֵ / sigma޹)
+    regionBits.resize(4);
+    std::vector<ImageBlock>& blocks = workspace.blocks();
+    for (int regionIdx = 0; regionIdx < 4; ++regionIdx) {
+        const Region& region = selectedRegions[regionIdx];
+        cv::Mat regionPatch = reducedImage(region.bounds);
+        reducedBlockProcessor.prepareBlocks(regionPatch, edgeBitmap, region.bounds, expectedWatermarkLength, workspace, blocks);
+
+        BitStream& bits = regionBits[regionIdx];
+        bits.clear();
+        bits.resize(expectedWatermarkLength, 0);
+        for (int i = 0; i < expectedWatermarkLength; ++i) {
+            const ImageBlock& block = blocks[i];
+            double sigma = fullBlockProcessor.calculateBlockStrength(block.isEdgeBlock);
+            double mean = block.dcCoefficient / std::sqrt(static_cast<double>(block.bounds.area()));
+            int floorValue = static_cast<int>(std::floor(mean / sigma));
+            bits.set(i, std::abs(floorValue % 2));
+        }
+    }
+
+    BitStream votedBits = BitStream::atLeast(regionBits, 2);
+
+    // СͼϾͨλ RS ʱֱΪ
+    if (watermarkDecoder.tryDecodeWatermark(votedBits, result.decodedText)) {
+        result.markerRate = static_cast<double>(votedBits.countOnes(votedBits.size() - markerLen, markerLen)) / markerLen;
+        result.confidence = 1.0;
+        result.verdict = PrescreenResult::Positive;
+        return result;
+    }
+
+    // ˮӡʱλԼһΪ 1ˮӡʱӽȫ 1
+    result.markerRate = static_cast<double>(votedBits.countOnes(votedBits.size() - markerLen, markerLen)) / markerLen;
+    result.confidence = std::min(1.0, std::max(0.0, (result.markerRate - 0.5) / 0.5));
+    if (result.confidence >= positiveConfidence) {
+        result.verdict = PrescreenResult::Positive;
+    } else if (result.confidence < negativeConfidence) {
+        result.verdict = PrescreenResult::Negative;
+    } else {
+        result.verdict = PrescreenResult::Ambiguous;
+    }
+    return result;
+}
@@ -0,0 +1,71 @@
+#ifndef WATERMARK_PRESCREENER_H
+#define WATERMARK_PRESCREENER_H
+
+#include "EdgeDetector.h"
+#include "RegionSelector.h"
+#include "BlockProcessor.h"
+#include "FrameWorkspace.h"
+#include "WatermarkDecoder.h"
+#include "WatermarkProfile.h"
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// Ԥɸ
+struct PrescreenResult {
+    enum Verdict {
+        Negative,  // ˮӡ
+        Ambiguous, // ޷жϣҪȡ
+        Positive   // ˮӡ (СͼϽɹ)
+    };
+
+    Verdict verdict = Ambiguous;
+    double confidence = 0.0; // 0~1λһ³̶ (ɹʱΪ 1)
+    double markerRate = 0.0; // ͶƱλΪ 1 ı (ˮӡʱԼΪ 0.5)
+    std::string decodedText; // СͼϼɽʱˮӡıΪ
+
+    // ǷҪתȡ
+    bool shouldEscalate() const { return verdict != Negative; }
+};
+
+// СֱԤɸ 1/scale ҶͼСͼԵ⡢ѡͿ黮֣
+// ÿֵ / sigma ż (ֱ޹) жÿһλٰλ (ȫ 1) һ³̶ȸŶȡ
+// ֻڴּͲȷĽӦ WatermarkExtractor ȡ
+class WatermarkPrescreener {
+public:
+    // scale ȡ 1, 2, 4, 8 (Ӧ IMREAD_REDUCED_GRAYSCALE_*)
+    // Ŷ >= positiveThreshold Ϊ< negativeThreshold ΪΪȷ
+    WatermarkPrescreener(int expectedWatermarkLength = 361, int edgeThreshold = 5, int scale = 4,
+                         double positiveThreshold = 0.6, double negativeThreshold = 0.2, int markerLength = 41);
+
+    // ļĲ (Canny / ֵԵֵ˹ȡ profileǶһ)
+    WatermarkPrescreener(const WatermarkProfile& profile, int expectedWatermarkLength = 361, int scale = 4,
+                         double positiveThreshold = 0.6, double negativeThreshold = 0.2, int markerLength = 41);
+
+    // СȡͼԤɸȡʧʱ׳ std::runtime_error
+    PrescreenResult prescreen(const std::string& imagePath);
+
+    // С Y ͨ (CV_8U) Ԥɸ
+    PrescreenResult prescreen(const cv::Mat& reducedImage);
+
+    int getScale() const { return scaleFactor; }
+
+private:
+    EdgeDetector edgeDetector;
+    RegionScorer regionScorer;
+    RegionSelector regionSelector;
+    BlockProcessor reducedBlockProcessor; // СͼϵĿ黮 (Եֵ 1/scale С)
+    BlockProcessor fullBlockProcessor; // ԭֱֵµǶǿ
+    WatermarkDecoder watermarkDecoder;
+
+    int expectedWatermarkLength;
+    int scaleFactor;
+    double positiveConfidence;
+    double negativeConfidence;
+    int markerLen;
+
+    FrameWorkspace workspace;
+    std::vector<BitStream> regionBits;
+};
+
+#endif // WATERMARK_PRESCREENER_H
@@ -0,0 +1,85 @@
+#include "WatermarkProfile.h"
+#include "utils.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+}
+
+std::string WatermarkProfile::describe() const {
+    std::ostringstream text;
+    text << "edge=" << edgeThreshold << " sigma=" << gaussianSigma << " win=" << windowScale << " step=" << stepScale
+         << " canny=" << cannyLow << "/" << cannyHigh << " post=" << postProcessThreshold;
+    return text.str();
+}
+
+void WatermarkProfile::save(const std::string& path, const std::string& comment) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Could not write profile: " + path);
+    }
+    std::stringstream commentLines(comment);
+    std::string line;
+    while (std::getline(commentLines, line)) {
+        out << "# " << line << "\n";
+    }
+    out << "edge_threshold = " << edgeThreshold << "\n";
+    out << "gaussian_sigma = " << gaussianSigma << "\n";
+    out << "window_scale = " << windowScale << "\n";
+    out << "step_scale = " << stepScale << "\n";
+    out << "canny_low = " << cannyLow << "\n";
+    out << "canny_high = " << cannyHigh << "\n";
+    out << "post_process_threshold = " << postProcessThreshold << "\n";
+    if (!out) {
+        throw std::runtime_error("Could not write profile: " + path);
+    }
+}
+
+WatermarkProfile WatermarkProfile::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Could not read profile: " + path);
+    }
+    WatermarkProfile profile;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument("Profile " + path + " line " + std::to_string(lineNumber) + ": expected key = value");
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        try {
+            if (key == "edge_threshold") profile.edgeThreshold = std::stoi(value);
+            else if (key == "gaussian_sigma") profile.gaussianSigma = std::stod(value);
+            else if (key == "window_scale") profile.windowScale = std::stod(value);
+            else if (key == "step_scale") profile.stepScale = std::stod(value);
+            else if (key == "canny_low") profile.cannyLow = std::stod(value);
+            else if (key == "canny_high") profile.cannyHigh = std::stod(value);
+            else if (key == "post_process_threshold") profile.postProcessThreshold = std::stod(value);
+            else libraryWarning() << "Warning: Unknown profile key '" << key << "' in " << path << " ignored." << std::endl;
+        } catch (const std::logic_error&) {
+            throw std::invalid_argument("Profile " + path + " line " + std::to_string(lineNumber) + ": invalid value for " + key);
+        }
+    }
+    if (profile.edgeThreshold < 0 || profile.gaussianSigma <= 0 || profile.windowScale <= 0 || profile.windowScale > 1
+        || profile.stepScale <= 0 || profile.stepScale > 1 || profile.cannyLow < 0 || profile.cannyHigh < profile.cannyLow) {
+        throw std::invalid_argument("Profile " + path + " has out-of-range values: " + profile.describe());
+    }
+    return profile;
+}
@@ -0,0 +1,28 @@
+#ifndef WATERMARK_PROFILE_H
+#define WATERMARK_PROFILE_H
+
+#include <string>
+
+// Ƕȡ˹õĿɵ (һ)ɱΪıļʱ
+// Ĭֵȱʡ (еĬϱԵֵ 5) һ
+struct WatermarkProfile {
+    int edgeThreshold = 5; // BlockProcessor Եֵ Th (ͬʱǶǿ)
+    double gaussianSigma = 1.5; // BlockProcessor Ե޸ĸ˹׼
+    double windowScale = 0.25; // RegionSelector 
+    double stepScale = 0.25; // RegionSelector 
+    double cannyLow = 50.0; // EdgeDetector Canny ֵ
+    double cannyHigh = 150.0; // EdgeDetector Canny ֵ
+    double postProcessThreshold = 30.0; // EdgeDetector ҶȲֵ
+
+    // ժҪ "edge=5 sigma=1.5 win=0.25 step=0.25 canny=50/150 post=30"
+    std::string describe() const;
+
+    // Ϊ "key = value" ıcomment ÿһ '#' ͷдļͷ
+    void save(const std::string& path, const std::string& comment = "") const;
+
+    // ȡļδֵļȡĬֵδ֪ļ
+    // ļ޷ȡʱ׳ std::runtime_errorȡֵǷʱ׳ std::invalid_argument
+    static WatermarkProfile load(const std::string& path);
+};
+
+#endif // WATERMARK_PROFILE_H
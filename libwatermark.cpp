@@ -0,0 +1,175 @@
+#include "libwatermark.h"
+#include "WatermarkEmbedder.h"
+#include "WatermarkExtractor.h"
+#include "utils.h"
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+struct wm_context {
+    mutable std::mutex mutex; // ͬһĵĵôִ (Ƕ / ȡĹɹ)Ҳ lastError
+    WatermarkEmbedder embedder;
+    WatermarkExtractor extractor;
+    std::string lastError;
+
+    explicit wm_context(const WatermarkProfile& profile)
+        : embedder(profile), extractor(361, profile) {}
+};
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+bool isValidPlane(const void* plane, int32_t width, int32_t height, size_t stride) {
+    return plane != nullptr && width > 0 && height > 0 && stride >= static_cast<size_t>(width);
+}
+
+// ѵǰ쳣תΪ״̬벢¼ԭ (ֻ catch е)
+wm_status translateException(wm_context* context) {
+    try {
+        throw;
+    } catch (const std::bad_alloc&) {
+        context->lastError = "Out of memory.";
+        return WM_OUT_OF_MEMORY;
+    } catch (const std::invalid_argument& e) {
+        context->lastError = e.what();
+        return WM_INVALID_ARGUMENT;
+    } catch (const std::exception& e) {
+        context->lastError = e.what();
+        return WM_FAILED;
+    } catch (...) {
+        context->lastError = "Unknown error.";
+        return WM_FAILED;
+    }
+}
+}
+
+int32_t wm_api_version(void) {
+    return WM_API_VERSION;
+}
+
+void wm_config_init(wm_config* config) {
+    if (config != nullptr) {
+        config->edge_threshold = 5;
+    }
+}
+
+wm_context* wm_create(const wm_config* config) {
+    wm_config settings;
+    wm_config_init(&settings);
+    if (config != nullptr) {
+        settings = *config;
+    }
+    try {
+        ScopedLibraryLogMute mute; // ֻڱεõ߳ڹرտ־Ķ̵ȫ״̬
+        WatermarkProfile profile;
+        profile.edgeThreshold = settings.edge_threshold;
+        return new wm_context(profile);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+wm_context* wm_create_from_profile(const char* profile_path) {
+    if (profile_path == nullptr) {
+        return nullptr;
+    }
+    try {
+        ScopedLibraryLogMute mute;
+        return new wm_context(WatermarkProfile::load(profile_path));
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void wm_destroy(wm_context* context) {
+    delete context;
+}
+
+wm_status wm_embed(wm_context* context, uint8_t* y_plane, int32_t width, int32_t height, size_t stride,
+                   const char* text, wm_embed_result* result) {
+    if (context == nullptr) {
+        return WM_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(context->mutex);
+    ScopedLibraryLogMute mute;
+    context->lastError.clear();
+    if (!isValidPlane(y_plane, width, height, stride) || text == nullptr || text[0] == '\0') {
+        context->lastError = "Invalid Y plane or empty watermark text.";
+        return WM_INVALID_ARGUMENT;
+    }
+    try {
+        std::string watermarkText(text, strnlen(text, WM_MAX_TEXT_LENGTH));
+        // ͵޸ĵ÷Ļֻд޸Ŀ
+        context->embedder.embedWatermarkInPlace(y_plane, width, height, stride, watermarkText);
+        if (result != nullptr) {
+            result->analysis_ms = context->embedder.getLastAnalysisMs();
+            result->embed_ms = context->embedder.getLastEmbedMs();
+        }
+        return WM_OK;
+    } catch (...) {
+        return translateException(context);
+    }
+}
+
+wm_status wm_extract(wm_context* context, const uint8_t* y_plane, int32_t width, int32_t height, size_t stride,
+                     wm_extract_result* result) {
+    if (context == nullptr) {
+        return WM_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(context->mutex);
+    ScopedLibraryLogMute mute;
+    context->lastError.clear();
+    if (!isValidPlane(y_plane, width, height, stride) || result == nullptr) {
+        context->lastError = "Invalid Y plane or result pointer.";
+        return WM_INVALID_ARGUMENT;
+    }
+    std::memset(result, 0, sizeof(*result));
+    try {
+        Clock::time_point start = Clock::now();
+        // ȡֻȡ
+        cv::Mat yPlane(height, width, CV_8UC1, const_cast<uint8_t*>(y_plane), stride);
+        std::string decodedText;
+        double confidence = 0.0;
+        bool found = context->extractor.tryExtract(yPlane, decodedText, confidence);
+        result->found = found ? 1 : 0;
+        result->confidence = confidence;
+        std::strncpy(result->text, decodedText.c_str(), sizeof(result->text) - 1);
+        result->elapsed_ms = elapsedMs(start);
+        if (!found) {
+            context->lastError = "No valid watermark found.";
+            return WM_NOT_FOUND;
+        }
+        return WM_OK;
+    } catch (...) {
+        return translateException(context);
+    }
+}
+
+const char* wm_last_error(const wm_context* context) {
+    if (context == nullptr) {
+        return "Null context.";
+    }
+    // ߳ԼĻ߳ͬʱڸϵҲдصַ
+    thread_local std::string lastErrorCopy;
+    std::lock_guard<std::mutex> lock(context->mutex);
+    lastErrorCopy = context->lastError;
+    return lastErrorCopy.c_str();
+}
+
+const char* wm_status_string(wm_status status) {
+    switch (status) {
+    case WM_OK: return "ok";
+    case WM_NOT_FOUND: return "not found";
+    case WM_INVALID_ARGUMENT: return "invalid argument";
+    case WM_FAILED: return "failed";
+    case WM_OUT_OF_MEMORY: return "out of memory";
+    default: return "unknown status";
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef LIBWATERMARK_H
+#define LIBWATERMARK_H
+
+/*
+ * libwatermark C++ ʱڵõȶ C ӿڡ
+ *
+ * - ֻʹ C ͣṹɵ÷䣬Ĳ (С) ٸı䣬ͨºṩ
+ *   WM_API_VERSION ڲ޸ʱ
+ * - 쳣Խӿڱ߽磬 wm_status أϸԭ wm_last_error ȡá
+ * -  stdout / stderr κ (ֻڵ߳ڹرտ־Ӱ̵)
+ * - ̰߳ȫͬĿڲͬ߳ϲʹãͬһĵĲڲִС
+ * - ͼ 8 λ Y ƽ () 룬stride Ϊʼַֽڲ (>= width)
+ *   ֱӴ YUV ֡ Y ƽ棬追дļ
+ *
+ * ʱ LIBWATERMARK_EXPORTS
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  ifdef LIBWATERMARK_EXPORTS
+#    define WM_API __declspec(dllexport)
+#  else
+#    define WM_API __declspec(dllimport)
+#  endif
+#else
+#  define WM_API __attribute__((visibility("default")))
+#endif
+
+#define WM_API_VERSION 1
+#define WM_MAX_TEXT_LENGTH 8 /* Ƕˮӡֽıض */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum wm_status {
+    WM_OK = 0,
+    WM_NOT_FOUND = 1,        /* ȡδͨλ RS  */
+    WM_INVALID_ARGUMENT = 2, /* ָ롢ߴ stride ǷˮӡΪյ */
+    WM_FAILED = 3,           /* г (ѡ㹻Ƕ) */
+    WM_OUT_OF_MEMORY = 4
+} wm_status;
+
+/* Ĳ wm_config_init Ĭֵ޸ */
+typedef struct wm_config {
+    int32_t edge_threshold; /* ԵֵĬ 5 (Ƕȡһ) */
+} wm_config;
+
+typedef struct wm_embed_result {
+    double analysis_ms; /* Ե⡢ѡ񡢿黮 */
+    double embed_ms;    /* ˮӡд */
+} wm_embed_result;
+
+typedef struct wm_extract_result {
+    int32_t found;        /*  0 ʾҵЧˮӡ */
+    char text[64];        /* ˮӡ '\0' β */
+    double confidence;    /* оŶ (0~1) */
+    double elapsed_ms;
+} wm_extract_result;
+
+/* ͸ģԤȵǶ / ȡ乤ø */
+typedef struct wm_context wm_context;
+
+/* رʱ WM_API_VERSION÷ݴ˼ͷļǷƥ */
+WM_API int32_t wm_api_version(void);
+
+WM_API void wm_config_init(wm_config* config);
+
+/* config Ϊ NULL ʱʹĬֵ edge_threshold Ĳ (Canny˹) ΪĬֵʧܷ NULL */
+WM_API wm_context* wm_create(const wm_config* config);
+
+/* ļ (CLI  --profile / tune ĸʽ) ģǶȡʹļеȫ
+ * ļ޷ȡǷʱ NULL */
+WM_API wm_context* wm_create_from_profile(const char* profile_path);
+WM_API void wm_destroy(wm_context* context);
+
+/*  text Ƕ뵽 Y ƽ棺͵޸ģֻд޸Ŀأ֡result Ϊ NULL */
+WM_API wm_status wm_embed(wm_context* context, uint8_t* y_plane, int32_t width, int32_t height, size_t stride,
+                          const char* text, wm_embed_result* result);
+
+/*  Y ƽȡˮӡҵʱ WM_OKδҵ WM_NOT_FOUND */
+WM_API wm_status wm_extract(wm_context* context, const uint8_t* y_plane, int32_t width, int32_t height, size_t stride,
+                            wm_extract_result* result);
+
+/* һεʧܵԭ (ɹʱΪմ)صǵ߳Լĸ
+ * ڱ߳һε wm_last_error ǰЧ߳ڸϵĵӰ */
+WM_API const char* wm_last_error(const wm_context* context);
+
+WM_API const char* wm_status_string(wm_status status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBWATERMARK_H */
@@ -4,24 +4,145 @@
 #include <opencv2/opencv.hpp>
 #include "WatermarkEmbedder.h"
 #include "WatermarkExtractor.h"
+#include "WatermarkAccumulator.h"
+#include "WatermarkPrescreener.h"
+#include "MultiHypothesisExtractor.h"
+#include "KeyframeSelector.h"
+#include "VideoSharder.h"
+#include "KeyframeExtractionPool.h"
+#include "LiveStreamEmbedder.h"
+#include "AsyncWatermarkService.h"
+#include "WatermarkDaemon.h"
+#include "RobustnessBenchmark.h"
+#include "ParameterTuner.h"
+#include "SelfCheck.h"
 #include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <algorithm>
+#include <cstdio>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#define popen _popen
+#define pclose _pclose
+#define PIPE_READ_MODE "rb"
+#else
+#define PIPE_READ_MODE "r"
+#endif
+
+// ȫѡ --profile <file> صĲ (δָʱΪĬֵ)ģʽ [edge_threshold] ֻеıԵֵ
+static WatermarkProfile activeProfile;
+static std::string activeProfilePath;
+
+WatermarkProfile profileWithEdgeThreshold(int edgeThreshold) {
+    WatermarkProfile profile = activeProfile;
+    profile.edgeThreshold = edgeThreshold;
+    return profile;
+}
+
+// ̵Ĳǰ׺ (·Լǰļ)
+std::vector<std::string> workerArguments(const char* progName) {
+    std::vector<std::string> arguments{progName};
+    if (!activeProfilePath.empty()) {
+        arguments.push_back("--profile");
+        arguments.push_back(activeProfilePath);
+    }
+    return arguments;
+}
 
 // ӡ÷˵
 void printUsage(const char* progName) {
     std::cerr << "Usage: " << std::endl;
     std::cerr << "  " << progName << " embed <input_image> <output_image> <watermark_text> [num_regions] [edge_threshold]" << std::endl;
-    std::cerr << "  " << progName << " extract <input_image> [edge_threshold]" << std::endl;
-    std::cerr << "  " << progName << " video-embed <input_video> <output_video> <watermark_text> [num_regions] [edge_threshold]" << std::endl;
-    std::cerr << "  " << progName << " video-extract <input_video> [edge_threshold]" << std::endl;
+    std::cerr << "  " << progName << " embed-batch <input_image> <output_dir> <recipients_file> [edge_threshold]" << std::endl;
+    std::cerr << "  " << progName << " extract <input_image> [edge_threshold] [cache_dir] [--gray]" << std::endl;
+    std::cerr << "  " << progName << " extract-multi <input_image> [scales]" << std::endl;
+    std::cerr << "  " << progName << " extract-resync <input_image> [edge_threshold] [search_radius]" << std::endl;
+    std::cerr << "  " << progName << " extract-batch <input_image> [more_images...]" << std::endl;
+    std::cerr << "  " << progName << " screen <input_image> [scale] [edge_threshold]" << std::endl;
+    std::cerr << "  " << progName << " video-embed <input_video> <output_video> <watermark_text> [num_regions] [edge_threshold] [fixed|scene]" << std::endl;
+    std::cerr << "  " << progName << " video-extract <input_video> [edge_threshold] [vote|soft|hard] [min_confidence] [fixed|iframes]" << std::endl;
+    std::cerr << "  " << progName << " stream-embed <input|-> <width> <height> <watermark_text> [period] [budget_ms] [edge_threshold]" << std::endl;
+    std::cerr << "  " << progName << " video-embed-sharded <input_video> <output_video> <watermark_text> <num_shards> [num_regions] [edge_threshold]" << std::endl;
+    std::cerr << "  " << progName << " video-extract-sharded <input_video> <num_shards> [edge_threshold]" << std::endl;
+    std::cerr << "  " << progName << " daemon <socket_path> [num_workers] [edge_threshold] [cache_dir]" << std::endl;
+    std::cerr << "  " << progName << " daemon-client <socket_path> <PING|STATS|SHUTDOWN|EMBED|EXTRACT|EMBED_SHM|EXTRACT_SHM> [fields...]" << std::endl;
+    std::cerr << "  " << progName << " daemon-bench <socket_path> <input_image> [requests] [connections] [edge_threshold]" << std::endl;
+    std::cerr << "  " << progName << " benchmark <image_dir|-> [configurations] [attacks] [synthetic_count] [report_csv]" << std::endl;
+    std::cerr << "  " << progName << " tune <image_dir|-> <profile_out> [target_success_rate] [attacks] [synthetic_count]" << std::endl;
+    std::cerr << "  " << progName << " self-check [checks...]" << std::endl;
+    std::cerr << "  Global option: --profile <file> loads tuned parameters (see 'tune') for the embedder and extractor." << std::endl;
     std::cerr << std::endl;
     std::cerr << "Arguments:" << std::endl;
     std::cerr << "  embed:        Embed a watermark." << std::endl;
-    std::cerr << "  extract:      Extract a watermark." << std::endl;
+    std::cerr << "  embed-batch:  Analyze the image once, precompute both bit variants of every block, and embed one" << std::endl;
+    std::cerr << "                watermark per line of <recipients_file>," << std::endl;
+    std::cerr << "                saving <output_dir>/<line_number>.png for each recipient." << std::endl;
+    std::cerr << "  extract:      Extract a watermark. --gray decodes the input straight to luma (for JPEG only the Y" << std::endl;
+    std::cerr << "                component: no chroma IDCT, upsampling or color conversion); rounding may differ slightly" << std::endl;
+    std::cerr << "                from the color path's luma." << std::endl;
+    std::cerr << "  extract-multi: Try a grid of edge thresholds, window sizes and image scales in parallel; stops" << std::endl;
+    std::cerr << "                at the first hypothesis that passes the marker and RS checks." << std::endl;
+    std::cerr << "  extract-resync: Re-align the block grid of every region (FFT correlation over offsets within" << std::endl;
+    std::cerr << "                +/- search_radius pixels, default 16) before extracting; for cropped or shifted images." << std::endl;
+    std::cerr << "  extract-batch: Submit every image to the asynchronous service at once (one warm extractor per" << std::endl;
+    std::cerr << "                worker thread) and print one structured result line per image with stage timings." << std::endl;
+    std::cerr << "  screen:       Fast reduced-resolution pre-screen (scale 1/2/4/8, default 4); escalates to a full" << std::endl;
+    std::cerr << "                extraction for positive or ambiguous hits. Exit code 0: watermark found, 1: not found." << std::endl;
+    std::cerr << "  stream-embed: Read raw yuv420p (limited range) frames of <width>x<height> from stdin ('-') or a named pipe," << std::endl;
+    std::cerr << "                embed into frames 0, [period], 2*[period], ... (default 30) and write the frames to stdout." << std::endl;
+    std::cerr << "                Each frame has a latency budget ([budget_ms], default 33): when the predicted embedding cost" << std::endl;
+    std::cerr << "                exceeds it, that period is skipped instead of stalling. With period 30 the output can be read" << std::endl;
+    std::cerr << "                by 'video-extract ... fixed'. Logs and p50/p99 go to stderr." << std::endl;
+    std::cerr << "                e.g. ffmpeg -i in.mp4 -f rawvideo -pix_fmt yuv420p - | prog stream-embed - 1280 720 ID | ffmpeg ..." << std::endl;
+    std::cerr << "  video-embed-sharded / video-extract-sharded: Split the video at keyframes into about <num_shards>" << std::endl;
+    std::cerr << "                segments, process them in parallel worker processes (every 30th frame of the whole video)," << std::endl;
+    std::cerr << "                then losslessly concatenate the segments / merge the per-segment vote tables." << std::endl;
+    std::cerr << "                (video-embed-segment / video-extract-segment are the internal worker modes.)" << std::endl;
+    std::cerr << "  daemon:       Serve embed/extract requests on a Unix domain socket with warm worker instances" << std::endl;
+    std::cerr << "                (one tab separated request per line, see WatermarkDaemon.h); stops on SHUTDOWN." << std::endl;
+    std::cerr << "  daemon-client: Send one request (fields joined with tabs) to a running daemon and print the reply." << std::endl;
+    std::cerr << "                e.g. prog daemon-client /tmp/wm.sock EXTRACT image.png" << std::endl;
+    std::cerr << "  daemon-bench: Compare requests/sec of [requests] (default 50) extractions of <input_image> through a" << std::endl;
+    std::cerr << "                running daemon over [connections] (default 4) connections against the same number of" << std::endl;
+    std::cerr << "                per-process 'extract' invocations run [connections] at a time." << std::endl;
+    std::cerr << "  benchmark:    Embed into every image of <image_dir> ('-' for none) plus [synthetic_count] (default 8)" << std::endl;
+    std::cerr << "                synthetic 512x512 images with each configuration, apply each attack chain, extract, and" << std::endl;
+    std::cerr << "                report decode success rate, bit error rate, PSNR and per-stage time (configurations in parallel)." << std::endl;
+    std::cerr << "                [configurations]: comma separated edge:window:step[:resync], default: the active profile." << std::endl;
+    std::cerr << "                [attacks]: comma separated chains of '+' joined attacks: none, jpeg:<quality>, scale:<factor>," << std::endl;
+    std::cerr << "                noise:<sigma>, blur:<sigma>, crop:<fraction>, h264:<crf> (needs ffmpeg), e.g. jpeg:75+scale:0.5." << std::endl;
+    std::cerr << "  tune:         Search window/step scale, edge threshold, Gaussian sigma and Canny / post-process thresholds" << std::endl;
+    std::cerr << "                on the benchmark corpus (default 6 synthetic images) for the fastest embed + extract that" << std::endl;
+    std::cerr << "                still decodes at least [target_success_rate] (default 0.95) of the images under every attack" << std::endl;
+    std::cerr << "                chain (default jpeg:75,scale:0.75,noise:2); saves it to <profile_out> for --profile." << std::endl;
+    std::cerr << "  self-check:   Measure implementation properties on synthetic images and report PASS/FAIL per check" << std::endl;
+    std::cerr << "                (default: all). workspace: allocations (operator new and Mat) of repeated same-size" << std::endl;
+    std::cerr << "                embed + extract. stripes: striped vs serial edge maps on synthetic 1080p and 4K." << std::endl;
+    std::cerr << "                resync: extraction after the benchmark's crop:0.02 attack with and without grid resync." << std::endl;
+    std::cerr << "                stream: stream-embed -> ffmpeg H.264 -> video-extract's frame export and extraction." << std::endl;
+    std::cerr << "                Exit code: number of failed checks." << std::endl;
     std::cerr << "  <input_image>: Path to the input image (grayscale)." << std::endl;
     std::cerr << "  <output_image>: Path to save the watermarked image (embed mode only)." << std::endl;
     std::cerr << "  <watermark_text>: The text to embed (embed mode only)." << std::endl;
     std::cerr << "  [num_regions]: (Optional, embed mode) Number of regions to select (default: derived from watermark length)." << std::endl;
     std::cerr << "  [edge_threshold]: (Optional) Threshold for classifying edge blocks (default: 5)." << std::endl;
+    std::cerr << "  [cache_dir]:  (Optional, extract) Directory of the on-disk analysis cache; repeat scans of the same" << std::endl;
+    std::cerr << "                image reuse the cached extraction result." << std::endl;
+    std::cerr << "  [scales]:     (Optional, extract-multi) Comma separated image scales to try (default: 1)." << std::endl;
+    std::cerr << "  [fixed|scene]: (Optional, video-embed) fixed: embed every 30th frame (default); scene: pick embedding frames" << std::endl;
+    std::cerr << "                by scene cuts and texture, skipping flat/fading frames, and force I-frames there." << std::endl;
+    std::cerr << "  [fixed|iframes]: (Optional, video-extract) fixed: every 30th frame (default); iframes: every I-frame" << std::endl;
+    std::cerr << "                (use for videos embedded with 'scene')." << std::endl;
+    std::cerr << "  [vote|soft|hard]: (Optional, video-extract) vote: decode every 30th frame and vote on the strings (default);" << std::endl;
+    std::cerr << "                    soft/hard: accumulate soft/hard bit votes across frames and stop at the first confident decode" << std::endl;
+    std::cerr << "                    (frames are streamed from ffmpeg, which is stopped as soon as the decode is confident)." << std::endl;
+    std::cerr << "  [min_confidence]: (Optional, video-extract soft/hard) Confidence (0~1) required to stop early (default: 0.2)." << std::endl;
     std::cerr << std::endl;
     std::cerr << "Note: Watermark length is fixed at 361 bits for extraction." << std::endl;
     std::cerr << std::endl;
@@ -31,11 +152,115 @@ void printUsage(const char* progName) {
     std::cerr << "  " << progName << " extract output.png 10" << std::endl;
     std::cerr << "Example (Video Extract):" << std::endl;
     std::cerr << "  " << progName << " video-extract output.mp4" << std::endl;
+    std::cerr << "  " << progName << " video-extract output.mp4 5 soft 0.3" << std::endl;
+}
+
+
+// ֶι̡Ƕ롣֡Ŵ frameOffset 㣬Ƶÿ30֡Ƕһεĵȣ
+// Ƶ (ƴʱɸ̼ӻ)ȫ֡Ϊ30ıǿ I ֡
+int embedVideoSegment(const std::string& inputSegment, const std::string& outputSegment, const std::string& watermarkText,
+                      int frameOffset, const std::string& tempDir, int numRegions, int edgeThreshold) {
+    std::filesystem::create_directories(tempDir);
+    std::string extractFrames = "ffmpeg -y -v error -i \"" + inputSegment + "\" -q:v 2 \"" + tempDir + "/frame_%05d.png\"";
+    system(extractFrames.c_str());
+
+    WatermarkEmbedder embedder(profileWithEdgeThreshold(edgeThreshold), numRegions == 0 ? 4 : numRegions);
+    int embeddedCount = 0;
+    for (int frameIdx = 1; ; ++frameIdx) {
+        char frameName[1024];
+        sprintf_s(frameName, "%s/frame_%05d.png", tempDir.c_str(), frameIdx);
+        if (!std::filesystem::exists(frameName)) break;
+        if ((frameOffset + frameIdx - 1) % 30 != 0) continue;
+        cv::Mat inputImage = cv::imread(frameName, cv::IMREAD_COLOR);
+        if (inputImage.empty()) break;
+        cv::Mat yuvInput;
+        cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
+        std::vector<cv::Mat> yuvChannels;
+        cv::split(yuvInput, yuvChannels);
+        embedder.embedWatermarkInPlace(yuvChannels[0], watermarkText);
+        cv::Mat watermarkedYUV, watermarkedBGR;
+        cv::merge(yuvChannels, watermarkedYUV);
+        cv::cvtColor(watermarkedYUV, watermarkedBGR, cv::COLOR_YCrCb2BGR);
+        cv::imwrite(frameName, watermarkedBGR); // ԭ֡
+        ++embeddedCount;
+    }
+
+    std::string composeVideo = "ffmpeg -y -v error -framerate 30 -i \"" + tempDir + "/frame_%05d.png\" -c:v libx264 -g 30 -sc_threshold 0"
+                             + " -force_key_frames \"expr:eq(mod(n+" + std::to_string(frameOffset) + ",30),0)\" \"" + outputSegment + "\"";
+    int status = system(composeVideo.c_str());
+    std::filesystem::remove_all(tempDir);
+    std::cout << "Segment " << inputSegment << ": embedded " << embeddedCount << " frame(s)." << std::endl;
+    return status == 0 ? 0 : -1;
+}
+
+// ֶι̡ȡȫ֡ÿ30֡ȡһΣƱд votesFile
+// (ÿ¼ "<Ʊ> <ֽ>\n<ˮӡԭʼֽ>\n"ˮӡеĻеֽڶƻʽ)
+int extractVideoSegment(const std::string& inputSegment, int frameOffset, const std::string& tempDir, int edgeThreshold, const std::string& votesFile) {
+    std::filesystem::create_directories(tempDir);
+    // ֻȫ֡Ϊ30ı֡tempDir/frame_%05d.png ζӦЩ֡
+    std::string extractKeyFrames = "ffmpeg -y -v error -i \"" + inputSegment + "\" -vf \"select=not(mod(n+" + std::to_string(frameOffset)
+                                 + "\\,30))\" -vsync vfr -q:v 2 \"" + tempDir + "/frame_%05d.png\"";
+    system(extractKeyFrames.c_str());
+
+    WatermarkExtractor extractor(361, profileWithEdgeThreshold(edgeThreshold));
+    extractor.setTemporalRegionReuse(true);
+    std::map<std::string, int> watermarkVotes;
+    for (int keyFrameIdx = 1; ; ++keyFrameIdx) {
+        char frameName[1024];
+        sprintf_s(frameName, "%s/frame_%05d.png", tempDir.c_str(), keyFrameIdx);
+        cv::Mat inputImage = cv::imread(frameName, cv::IMREAD_COLOR);
+        if (inputImage.empty()) break;
+        cv::Mat yuvInput;
+        cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
+        std::vector<cv::Mat> yuvChannels;
+        cv::split(yuvInput, yuvChannels);
+        std::string extractedText;
+        try {
+            extractedText = extractor.extractWatermark(yuvChannels[0]);
+        } catch (...) {
+            extractedText = "";
+        }
+        if (!extractedText.empty()) {
+            watermarkVotes[extractedText]++;
+        }
+    }
+    std::filesystem::remove_all(tempDir);
+    const TemporalRegionCache& regionHints = extractor.getTemporalRegionCache();
+    std::cout << "Segment " << inputSegment << ": region hints accepted " << regionHints.getAcceptedCount() << ", rejected "
+              << regionHints.getRejectedCount() << ", none for " << regionHints.getMissCount() << " frame(s) (first frame or shot change)." << std::endl;
+
+    std::ofstream votes(votesFile, std::ios::binary);
+    for (const auto& vote : watermarkVotes) {
+        votes << vote.second << " " << vote.first.size() << "\n";
+        votes.write(vote.first.data(), static_cast<std::streamsize>(vote.first.size()));
+        votes << "\n";
+    }
+    return votes ? 0 : -1;
 }
 
 
 int main(int argc, char** argv) {
     cv::utils::logging::setLogLevel(cv::utils::logging::LOG_LEVEL_ERROR);
+    // ȫѡ --profile <file> ɳλãȡӲбƳ
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--profile") {
+            activeProfilePath = argv[i + 1];
+            for (int j = i; j + 2 <= argc; ++j) {
+                argv[j] = argv[j + 2];
+            }
+            argc -= 2;
+            break;
+        }
+    }
+    if (argc >= 2 && std::string(argv[1]) == "self-check") {
+        // Լ첻Ҫļڼرտ־ֻ
+        std::vector<std::string> checks(argv + 2, argv + argc);
+        setLibraryLogEnabled(false);
+        int failures = SelfCheck::run(checks, std::cout);
+        setLibraryLogEnabled(true);
+        std::cout << (failures == 0 ? "All checks passed." : std::to_string(failures) + " check(s) failed.") << std::endl;
+        return failures;
+    }
     if (argc < 3) {
         printUsage(argv[0]);
         return -1;
@@ -44,6 +269,21 @@ int main(int argc, char** argv) {
     std::string mode = argv[1];
     std::string inputImagePath = argv[2];
 
+    // extract ѡ --grayֱӰҶȽ (JPEG  libjpeg ֻ Y ɫ IDCTϲɫת)
+    bool grayDecode = false;
+    if (mode == "extract") {
+        for (int i = 3; i < argc; ++i) {
+            if (std::string(argv[i]) == "--gray") {
+                grayDecode = true;
+                for (int j = i; j + 1 <= argc; ++j) {
+                    argv[j] = argv[j + 1];
+                }
+                --argc;
+                break;
+            }
+        }
+    }
+
     // Ƶʱļ
     std::string tempFrame = "__temp_frame.png";
     std::string tempFrameOut = "__temp_frame_out.png";
@@ -52,6 +292,13 @@ int main(int argc, char** argv) {
     int edgeThreshold = 5; // ĬϱԵֵ
 
     try {
+        if (!activeProfilePath.empty()) {
+            activeProfile = WatermarkProfile::load(activeProfilePath);
+            edgeThreshold = activeProfile.edgeThreshold;
+            // д stderrstream-embed  stdout ֻ֡
+            std::cerr << "Loaded profile " << activeProfilePath << ": " << activeProfile.describe() << std::endl;
+        }
+
         if (mode == "video-embed") {
             std::filesystem::create_directory("temp");
             if (argc < 5) {
@@ -75,35 +322,80 @@ int main(int argc, char** argv) {
             if (argc > 6) {
                 try { edgeThreshold = std::stoi(argv[6]); } catch (...) {}
             }
+            std::string keyframeMode = (argc > 7) ? argv[7] : "fixed";
+            if (keyframeMode != "fixed" && keyframeMode != "scene") {
+                std::cerr << "Warning: Unknown keyframe mode '" << keyframeMode << "'. Using fixed." << std::endl;
+                keyframeMode = "fixed";
+            }
             // 1. ȡ֡ΪͼƬ
             std::string extractFrames = "ffmpeg -y -i \"" + inputImagePath + "\" -q:v 2 temp/frame_%05d.png";
             system(extractFrames.c_str());
-            // 2. ÿ30֡Ƕһˮӡ
-            int frameIdx = 1;
-            while (true) {
+            // 2. ȷǶ֡ ( 1 ʼ֡)fixed Ϊÿ30֡һΣscene С֡֡ / ѡ
+            std::vector<int> embedFrames;
+            int frameCount = 0;
+            if (keyframeMode == "scene") {
+                KeyframeSelector keyframeSelector;
+                cv::Mat smallLuma;
+                while (true) {
+                    char frameName[64];
+                    sprintf_s(frameName, "temp/frame_%05d.png", frameCount + 1);
+                    smallLuma = cv::imread(frameName, cv::IMREAD_REDUCED_GRAYSCALE_4);
+                    if (smallLuma.empty()) break;
+                    keyframeSelector.addFrame(smallLuma);
+                    ++frameCount;
+                }
+                for (int keyframe : keyframeSelector.selectKeyframes()) {
+                    embedFrames.push_back(keyframe + 1);
+                }
+                std::cout << "Scene-aware selection: " << embedFrames.size() << " embedding frame(s) out of " << frameCount << std::endl;
+            } else {
+                while (true) {
+                    char frameName[64];
+                    sprintf_s(frameName, "temp/frame_%05d.png", frameCount + 1);
+                    if (!std::filesystem::exists(frameName)) break;
+                    if (frameCount % 30 == 0) { // ÿ30֡Ƕһ
+                        embedFrames.push_back(frameCount + 1);
+                    }
+                    ++frameCount;
+                }
+            }
+            // 3. ֻдǶ֡ (Ƕ֡临ãڲֻڵһ֡)
+            WatermarkEmbedder embedder(profileWithEdgeThreshold(edgeThreshold), numRegions == 0 ? 4 : numRegions);
+            for (int frameIdx : embedFrames) {
                 char frameName[64];
                 sprintf_s(frameName, "temp/frame_%05d.png", frameIdx);
                 cv::Mat inputImage = cv::imread(frameName, cv::IMREAD_COLOR);
                 if (inputImage.empty()) break;
-                if ((frameIdx-1) % 30 == 0) { // ÿ30֡Ƕһ
-                    cv::Mat yuvInput;
-                    cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
-                    std::vector<cv::Mat> yuvChannels;
-                    cv::split(yuvInput, yuvChannels);
-                    WatermarkEmbedder embedder(numRegions == 0 ? 4 : numRegions, edgeThreshold);
-                    cv::Mat watermarkedY = embedder.embedWatermark(yuvChannels[0], watermarkText);
-                    yuvChannels[0] = watermarkedY;
-                    cv::Mat watermarkedYUV, watermarkedBGR;
-                    cv::merge(yuvChannels, watermarkedYUV);
-                    cv::cvtColor(watermarkedYUV, watermarkedBGR, cv::COLOR_YCrCb2BGR);
-                    cv::imwrite(frameName, watermarkedBGR); // ԭ֡
+                cv::Mat yuvInput;
+                cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
+                std::vector<cv::Mat> yuvChannels;
+                cv::split(yuvInput, yuvChannels);
+                embedder.embedWatermarkInPlace(yuvChannels[0], watermarkText);
+                cv::Mat watermarkedYUV, watermarkedBGR;
+                cv::merge(yuvChannels, watermarkedYUV);
+                cv::cvtColor(watermarkedYUV, watermarkedBGR, cv::COLOR_YCrCb2BGR);
+                cv::imwrite(frameName, watermarkedBGR); // ԭ֡
+            }
+            // 4. ϳƵӻԭƵI֡Ƕ֡
+            std::string keyframeOptions = "-g 30 -keyint_min 30 -sc_threshold 0"; // ǿÿ30֡һI֡
+            if (keyframeMode == "scene") {
+                // Ƕ֡ǿ I ֡ (ʱȡǰ֡⸡䵽һ֡)رճлⲢſ GOP
+                // ʹ I ֡٣ȡ˰ I ֡ѡ֡ (video-extract ... iframes) ʱֻȡǶ֡
+                std::ostringstream forcedTimes;
+                forcedTimes.setf(std::ios::fixed);
+                forcedTimes.precision(4);
+                for (size_t i = 0; i < embedFrames.size(); ++i) {
+                    forcedTimes << (i > 0 ? "," : "") << std::max(0.0, (embedFrames[i] - 1.5) / 30.0);
                 }
-                ++frameIdx;
+                keyframeOptions = "-g 600 -sc_threshold 0 -force_key_frames " + forcedTimes.str();
             }
-            // 3. ϳƵӻԭƵǿÿ30֡һI֡
-            std::string composeVideo = "ffmpeg -y -framerate 30 -i temp/frame_%05d.png -i \"" + inputImagePath + "\" -map 0:v -map 1:a? -c:v libx264 -g 30 -keyint_min 30 -sc_threshold 0 -c:a copy \"" + outputVideoPath + "\"";
+            std::string composeVideo = "ffmpeg -y -framerate 30 -i temp/frame_%05d.png -i \"" + inputImagePath + "\" -map 0:v -map 1:a? -c:v libx264 " + keyframeOptions + " -c:a copy \"" + outputVideoPath + "\"";
             system(composeVideo.c_str());
-            std::cout << "Watermark embedded to every 30th frame (I֡). Output video: " << outputVideoPath << std::endl;
+            if (keyframeMode == "scene") {
+                std::cout << "Watermark embedded to " << embedFrames.size() << " scene-selected frames (I֡). Output video: " << outputVideoPath << std::endl;
+            } else {
+                std::cout << "Watermark embedded to every 30th frame (I֡). Output video: " << outputVideoPath << std::endl;
+            }
             std::filesystem::remove_all("temp");
             return 0;
         }        if (mode == "video-extract") {
@@ -118,46 +410,108 @@ int main(int argc, char** argv) {
             if (argc > 3) {
                 try { edgeThreshold = std::stoi(argv[3]); } catch (...) {}
             }
-            // 1. ȡ֡ΪͼƬ
-            std::string extractFrames = "ffmpeg -y -i \"" + inputImagePath + "\" -q:v 2 temp/frame_%05d.png";
-            system(extractFrames.c_str());
-            // 2. ÿ30֡ȡһˮӡͶƱƣRSʧܵĲ
-            int frameIdx = 1;
-            std::map<std::string, int> watermarkVotes;
-            while (true) {
-                char frameName[64];
-                sprintf_s(frameName, "temp/frame_%05d.png", frameIdx);
-                cv::Mat inputImage = cv::imread(frameName, cv::IMREAD_COLOR);
-                if (inputImage.empty()) break;
-                if ((frameIdx-1) % 30 == 0) {
+            std::string accumulateMode = (argc > 4) ? argv[4] : "vote";
+            double minConfidence = 0.2;
+            if (argc > 5) {
+                try { minConfidence = std::stod(argv[5]); } catch (...) {}
+            }
+            if (accumulateMode != "vote" && accumulateMode != "soft" && accumulateMode != "hard") {
+                std::cerr << "Warning: Unknown accumulate mode '" << accumulateMode << "'. Using vote." << std::endl;
+                accumulateMode = "vote";
+            }
+            // fixed: Ƕ֡Ϊÿ30֡ĵ1֡iframes: Ƕ֡Ϊ I ֡ (video-embed ... scene )
+            std::string frameSelection = (argc > 6) ? argv[6] : "fixed";
+            if (frameSelection != "fixed" && frameSelection != "iframes") {
+                std::cerr << "Warning: Unknown frame selection '" << frameSelection << "'. Using fixed." << std::endl;
+                frameSelection = "fixed";
+            }
+            bool useIFrames = (frameSelection == "iframes");
+            std::string keyFrameFilter = useIFrames ? "select=eq(pict_type\\,I)" : "select=not(mod(n\\,30))";
+            if (accumulateMode == "soft" || accumulateMode == "hard") {
+                // Ƕˮӡ֡ܵ BGR24 ԭʼ֡֡ (fixed ʱΪ 1, 31, 61... ֡)
+                // ۻﵽŶȺرչܵffmpeg 漴˳ȰƵĹؼ֡ȫ
+                int frameWidth = 0, frameHeight = 0;
+                VideoSharder::probeFrameSize(inputImagePath, frameWidth, frameHeight);
+                std::string pipeKeyFrames = "ffmpeg -v error -i \"" + inputImagePath + "\" -vf \"" + keyFrameFilter + "\" -vsync vfr -f rawvideo -pix_fmt bgr24 -";
+                FILE* framePipe = popen(pipeKeyFrames.c_str(), PIPE_READ_MODE);
+                if (framePipe == nullptr) {
+                    std::cerr << "Error: Could not start ffmpeg for " << inputImagePath << std::endl;
+                    return -1;
+                }
+                cv::Mat inputImage(frameHeight, frameWidth, CV_8UC3);
+                const size_t frameBytes = inputImage.total() * inputImage.elemSize();
+                WatermarkExtractor extractor(expectedLength, profileWithEdgeThreshold(edgeThreshold));
+                WatermarkAccumulator accumulator(expectedLength,
+                    accumulateMode == "soft" ? WatermarkAccumulator::Mode::Soft : WatermarkAccumulator::Mode::Hard,
+                    minConfidence);
+                std::string decodedText;
+                std::string lastDecodedText;
+                for (int keyFrameIdx = 1; fread(inputImage.data, 1, frameBytes, framePipe) == frameBytes; ++keyFrameIdx) {
+                    int frameIdx = useIFrames ? keyFrameIdx : (keyFrameIdx - 1) * 30 + 1; // iframes ʱΪ I ֡
                     cv::Mat yuvInput;
                     cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
                     std::vector<cv::Mat> yuvChannels;
                     cv::split(yuvInput, yuvChannels);
-                    WatermarkExtractor extractor(expectedLength, edgeThreshold);
-                    std::string extractedText;
+                    std::vector<BitStream> hardBits;
+                    std::vector<std::vector<double>> softBits;
                     try {
-                        extractedText = extractor.extractWatermark(yuvChannels[0]);
-                    } catch (...) {
-                        extractedText = "";
+                        extractor.extractRegionBits(yuvChannels[0], hardBits, softBits);
+                        accumulator.addFrame(hardBits, softBits);
+                    } catch (const std::exception& e) {
+                        std::cout << "Frame " << frameIdx << ": skipped (" << e.what() << ")" << std::endl;
+                        continue;
                     }
-                    if (!extractedText.empty()) {
-                        watermarkVotes[extractedText]++;
-                        std::cout << "Frame " << frameIdx << ": " << extractedText << std::endl;
-                    } else {
-                        std::cout << "Frame " << frameIdx << ": (no valid watermark)" << std::endl;
+                    if (accumulator.tryDecode(decodedText)) {
+                        lastDecodedText = decodedText;
                     }
+                    std::cout << "Frame " << frameIdx << ": accumulated " << accumulator.getFrameCount()
+                              << " frame(s), confidence " << accumulator.getConfidence() << std::endl;
+                    if (accumulator.isConfident()) {
+                        break;
+                    }
+                }
+                pclose(framePipe); // ǰʱ ffmpeg дܵʧܺ˳
+                std::filesystem::remove_all("temp");
+                if (accumulator.isConfident()) {
+                    std::cout << "\nFinal accumulated watermark: " << decodedText << " (" << accumulator.getFrameCount()
+                              << " frames, confidence " << accumulator.getConfidence() << ")" << std::endl;
+                    return 0;
+                } else if (!lastDecodedText.empty()) {
+                    std::cout << "\nFinal accumulated watermark (below confidence " << minConfidence << "): " << lastDecodedText << std::endl;
+                    return 0;
+                } else {
+                    std::cout << "No valid watermark decoded from " << accumulator.getFrameCount() << " accumulated I-frame(s)." << std::endl;
+                    return 1;
                 }
-                ++frameIdx;
             }
+            // 1. ֻǶˮӡĹؼ֡ (fixed: ÿ30֡ĵ1֡iframes: I ֡)
+            std::string extractKeyFrames = "ffmpeg -y -i \"" + inputImagePath + "\" -vf \"" + keyFrameFilter + "\" -vsync vfr -q:v 2 temp/frame_%05d.png";
+            system(extractKeyFrames.c_str());
+            std::vector<std::string> keyFramePaths;
+            std::vector<int> keyFrameNumbers;
+            for (int keyFrameIdx = 1; ; ++keyFrameIdx) {
+                char frameName[64];
+                sprintf_s(frameName, "temp/frame_%05d.png", keyFrameIdx);
+                if (!std::filesystem::exists(frameName)) break;
+                keyFramePaths.push_back(frameName);
+                keyFrameNumbers.push_back(useIFrames ? keyFrameIdx : (keyFrameIdx - 1) * 30 + 1); // iframes ʱΪ I ֡
+            }
+            // 2. ؼַ߲֡ȡͶƱƣRSʧܵĲ룻֡֡˳
+            KeyframeExtractionPool extractionPool(expectedLength, profileWithEdgeThreshold(edgeThreshold));
+            std::cout << "Extracting " << keyFramePaths.size() << " key frame(s) with " << extractionPool.getWorkerCount() << " worker(s)..." << std::endl;
+            extractionPool.run(keyFramePaths, keyFrameNumbers, [](const KeyframeResult& result) {
+                if (result.valid) {
+                    std::cout << "Frame " << result.frameNumber << ": " << result.text << std::endl;
+                } else {
+                    std::cout << "Frame " << result.frameNumber << ": (no valid watermark)" << std::endl;
+                }
+            });
             std::filesystem::remove_all("temp");
             // Ʊˮӡ
-            if (!watermarkVotes.empty()) {
-                auto maxVote = std::max_element(watermarkVotes.begin(), watermarkVotes.end(),
-                    [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) {
-                        return a.second < b.second;
-                    });
-                std::cout << "\nFinal voted watermark: " << maxVote->first << " (" << maxVote->second << " votes)" << std::endl;
+            std::string votedText;
+            int voteCount = 0;
+            if (extractionPool.getVotes().top(votedText, voteCount)) {
+                std::cout << "\nFinal voted watermark: " << votedText << " (" << voteCount << " votes)" << std::endl;
                 return 0;
             } else {
                 std::cout << "No valid watermark extracted from any I-frame." << std::endl;
@@ -165,8 +519,466 @@ int main(int argc, char** argv) {
             }
         }
 
-        // ͼ (ɫ)
-        cv::Mat inputImage = cv::imread(inputImagePath, cv::IMREAD_COLOR);
+        if (mode == "stream-embed") {
+            if (argc < 6) {
+                std::cerr << "Error: Missing arguments for stream-embed mode." << std::endl;
+                printUsage(argv[0]);
+                return -1;
+            }
+            int width = std::stoi(argv[3]);
+            int height = std::stoi(argv[4]);
+            std::string watermarkText = argv[5];
+            if (watermarkText.length() > 8) {
+                watermarkText = watermarkText.substr(0, 8);
+                std::cerr << "Watermark text truncated to 8 characters: " << watermarkText << std::endl;
+            }
+            int period = 30;
+            double budgetMs = 33.0;
+            if (argc > 6) {
+                try { period = std::stoi(argv[6]); } catch (...) {}
+            }
+            if (argc > 7) {
+                try { budgetMs = std::stod(argv[7]); } catch (...) {}
+            }
+            if (argc > 8) {
+                try { edgeThreshold = std::stoi(argv[8]); } catch (...) {}
+            }
+
+            FILE* input = (inputImagePath == "-") ? stdin : fopen(inputImagePath.c_str(), "rb");
+            if (input == nullptr) {
+                std::cerr << "Error: Could not open stream input: " << inputImagePath << std::endl;
+                return -1;
+            }
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+            if (input == stdin) _setmode(_fileno(stdin), _O_BINARY);
+#endif
+            // stdout ֻ֡ݣ̵־д stderr
+            std::streambuf* coutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+            LiveStreamEmbedder streamEmbedder(width, height, watermarkText, period, budgetMs, profileWithEdgeThreshold(edgeThreshold));
+            std::vector<uint8_t> frame(streamEmbedder.getFrameBytes());
+            while (fread(frame.data(), 1, frame.size(), input) == frame.size()) {
+                streamEmbedder.processFrame(frame.data());
+                if (fwrite(frame.data(), 1, frame.size(), stdout) != frame.size()) {
+                    break; // ѹر
+                }
+                fflush(stdout);
+            }
+            if (input != stdin) fclose(input);
+            std::cout.rdbuf(coutBuffer);
+
+            LiveStreamStats streamStats = streamEmbedder.getStats();
+            std::cerr << "Stream: " << streamStats.frames << " frames, " << streamStats.embedded << " embedded, "
+                      << streamStats.skipped << " scheduled frame(s) skipped (over budget or no regions)" << std::endl;
+            std::cerr << "Per-frame latency: p50 " << streamStats.p50Ms << " ms, p99 " << streamStats.p99Ms
+                      << " ms, max " << streamStats.maxMs << " ms (budget " << budgetMs << " ms)" << std::endl;
+            return 0;
+        }
+
+        if (mode == "video-embed-segment") {
+            // ڲ̣<segment> <output_segment> <watermark_text> <frame_offset> <temp_dir> [num_regions] [edge_threshold]
+            if (argc < 7) {
+                std::cerr << "Error: Missing arguments for video-embed-segment mode." << std::endl;
+                return -1;
+            }
+            int numRegions = (argc > 7) ? std::stoi(argv[7]) : 0;
+            if (argc > 8) edgeThreshold = std::stoi(argv[8]);
+            return embedVideoSegment(inputImagePath, argv[3], argv[4], std::stoi(argv[5]), argv[6], numRegions, edgeThreshold);
+        }
+
+        if (mode == "video-extract-segment") {
+            // ڲ̣<segment> <frame_offset> <temp_dir> <votes_file> [edge_threshold]
+            if (argc < 6) {
+                std::cerr << "Error: Missing arguments for video-extract-segment mode." << std::endl;
+                return -1;
+            }
+            if (argc > 6) edgeThreshold = std::stoi(argv[6]);
+            return extractVideoSegment(inputImagePath, std::stoi(argv[3]), argv[4], edgeThreshold, argv[5]);
+        }
+
+        if (mode == "video-embed-sharded" || mode == "video-extract-sharded") {
+            bool embedMode = (mode == "video-embed-sharded");
+            int shardArg = embedMode ? 5 : 3;
+            if (argc <= shardArg) {
+                std::cerr << "Error: Missing arguments for " << mode << " mode." << std::endl;
+                printUsage(argv[0]);
+                return -1;
+            }
+            int numShards = std::max(1, std::stoi(argv[shardArg]));
+            int numRegions = 0;
+            std::string watermarkText;
+            if (embedMode) {
+                watermarkText = argv[4];
+                if (watermarkText.length() > 8) {
+                    watermarkText = watermarkText.substr(0, 8);
+                    std::cout << "Watermark text truncated to 8 characters: " << watermarkText << std::endl;
+                }
+                if (argc > 6) {
+                    try { numRegions = std::max(0, std::stoi(argv[6])); } catch (...) {}
+                }
+                if (argc > 7) {
+                    try { edgeThreshold = std::stoi(argv[7]); } catch (...) {}
+                }
+            } else if (argc > 4) {
+                try { edgeThreshold = std::stoi(argv[4]); } catch (...) {}
+            }
+
+            // 1. ڹؼ֡з֣õÿεȫʼ֡
+            VideoSharder sharder("temp_shards");
+            std::vector<VideoSegment> segments = sharder.split(inputImagePath, numShards);
+            std::cout << "Split into " << segments.size() << " segment(s) at keyframe boundaries." << std::endl;
+
+            // 2. ÿһ̣д
+            std::vector<std::vector<std::string>> commands;
+            std::vector<std::string> outputs;
+            for (size_t i = 0; i < segments.size(); ++i) {
+                const VideoSegment& segment = segments[i];
+                std::string tempDir = sharder.getWorkDirectory() + "/work_" + std::to_string(i);
+                std::vector<std::string> command = workerArguments(argv[0]);
+                if (embedMode) {
+                    outputs.push_back(sharder.getWorkDirectory() + "/embedded_" + std::to_string(i) + ".mp4");
+                    command.insert(command.end(), {"video-embed-segment", segment.path, outputs.back(), watermarkText,
+                                                   std::to_string(segment.firstFrame), tempDir, std::to_string(numRegions), std::to_string(edgeThreshold)});
+                } else {
+                    outputs.push_back(sharder.getWorkDirectory() + "/votes_" + std::to_string(i) + ".bin");
+                    command.insert(command.end(), {"video-extract-segment", segment.path, std::to_string(segment.firstFrame), tempDir,
+                                                   outputs.back(), std::to_string(edgeThreshold)});
+                }
+                commands.push_back(command);
+            }
+            int failures = VideoSharder::runParallel(commands);
+            if (failures > 0) {
+                std::cerr << "Error: " << failures << " segment worker(s) failed." << std::endl;
+                std::filesystem::remove_all(sharder.getWorkDirectory());
+                return -1;
+            }
+
+            // 3. Ƕ룺ƴӲӻԭƵȡϲƱ
+            if (embedMode) {
+                std::string outputVideoPath = argv[3];
+                sharder.concatenate(outputs, inputImagePath, outputVideoPath);
+                std::filesystem::remove_all(sharder.getWorkDirectory());
+                std::cout << "Watermark embedded to every 30th frame across " << segments.size() << " segment(s). Output video: " << outputVideoPath << std::endl;
+                return 0;
+            }
+            ShardedVoteTable watermarkVotes;
+            for (const std::string& votesFile : outputs) {
+                std::ifstream votes(votesFile, std::ios::binary);
+                int count = 0;
+                size_t length = 0;
+                while (votes >> count >> length) {
+                    // ˮӡ̣ܶȳΧ˵ļ
+                    if (votes.get() != '\n' || length > 4096) {
+                        throw std::runtime_error("Corrupt votes file: " + votesFile);
+                    }
+                    std::string text(length, '\0');
+                    if (!votes.read(&text[0], static_cast<std::streamsize>(length)) || votes.get() != '\n') {
+                        throw std::runtime_error("Corrupt votes file: " + votesFile);
+                    }
+                    watermarkVotes.add(text, count);
+                }
+            }
+            std::filesystem::remove_all(sharder.getWorkDirectory());
+            std::string votedText;
+            int voteCount = 0;
+            if (!watermarkVotes.top(votedText, voteCount)) {
+                std::cout << "No valid watermark extracted from any I-frame." << std::endl;
+                return 1;
+            }
+            std::cout << "\nFinal voted watermark: " << votedText << " (" << voteCount << " votes)" << std::endl;
+            return 0;
+        }
+
+        if (mode == "extract-batch") {
+            std::vector<std::string> inputPaths(argv + 2, argv + argc);
+            std::vector<std::future<ExtractResult>> pending;
+            {
+                AsyncWatermarkService service(0, profileWithEdgeThreshold(edgeThreshold));
+                std::cout << "Submitting " << inputPaths.size() << " images to " << service.getWorkerCount() << " workers..." << std::endl;
+                auto batchStart = std::chrono::steady_clock::now();
+                for (const std::string& path : inputPaths) {
+                    pending.push_back(service.extractFileAsync(path));
+                }
+                int foundCount = 0;
+                for (size_t i = 0; i < pending.size(); ++i) {
+                    ExtractResult result = pending[i].get();
+                    const char* statusName = result.status == WatermarkStatus::Ok ? "ok"
+                                           : result.status == WatermarkStatus::NotFound ? "not_found"
+                                           : result.status == WatermarkStatus::InvalidInput ? "invalid_input" : "failed";
+                    char timingText[256];
+                    sprintf_s(timingText, "queue %.1f ms, decode %.1f ms, extract %.1f ms, total %.1f ms",
+                              result.timings.queueMs, result.timings.decodeMs, result.timings.analysisMs, result.timings.totalMs);
+                    std::cout << inputPaths[i] << ": " << statusName;
+                    if (result.status == WatermarkStatus::Ok) {
+                        std::cout << " \"" << result.text << "\" confidence " << result.confidence;
+                        ++foundCount;
+                    } else if (!result.message.empty()) {
+                        std::cout << " (" << result.message << ")";
+                    }
+                    std::cout << " [" << timingText << "]" << std::endl;
+                }
+                double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchStart).count();
+                std::cout << foundCount << "/" << inputPaths.size() << " watermarks found in " << totalMs << " ms" << std::endl;
+                if (foundCount == 0) {
+                    return 1;
+                }
+            }
+            return 0;
+        }
+
+        if (mode == "daemon") {
+            int numWorkers = 0;
+            std::string cacheDir;
+            if (argc > 3) {
+                try { numWorkers = std::stoi(argv[3]); } catch (...) {}
+            }
+            if (argc > 4) {
+                try { edgeThreshold = std::stoi(argv[4]); } catch (...) {}
+            }
+            if (argc > 5) {
+                cacheDir = argv[5];
+            }
+            WatermarkDaemon daemon(inputImagePath, numWorkers, profileWithEdgeThreshold(edgeThreshold), cacheDir);
+            std::cout << "Watermark daemon listening on " << inputImagePath << " with " << daemon.getWorkerCount() << " workers." << std::endl;
+            daemon.run();
+            std::cout << "Daemon stopped after " << daemon.getRequestCount() << " requests." << std::endl;
+            return 0;
+        }
+
+        if (mode == "daemon-client") {
+            if (argc < 4) {
+                printUsage(argv[0]);
+                return -1;
+            }
+            std::string request = argv[3];
+            for (int i = 4; i < argc; ++i) {
+                request += "\t";
+                request += argv[i];
+            }
+            LocalSocket connection = LocalSocket::connect(inputImagePath);
+            std::string reply;
+            if (!connection.writeLine(request) || !connection.readLine(reply)) {
+                std::cerr << "Error: No reply from daemon." << std::endl;
+                return -1;
+            }
+            std::cout << reply << std::endl;
+            return reply.compare(0, 2, "OK") == 0 ? 0 : 1;
+        }
+
+        if (mode == "daemon-bench") {
+            if (argc < 4) {
+                printUsage(argv[0]);
+                return -1;
+            }
+            std::string benchImagePath = argv[3];
+            int numRequests = 50;
+            int numConnections = 4;
+            if (argc > 4) {
+                try { numRequests = std::max(1, std::stoi(argv[4])); } catch (...) {}
+            }
+            if (argc > 5) {
+                try { numConnections = std::max(1, std::stoi(argv[5])); } catch (...) {}
+            }
+            if (argc > 6) {
+                try { edgeThreshold = std::stoi(argv[6]); } catch (...) {}
+            }
+
+            // 1. פÿһ̣߳Ӽ䲢˳
+            std::atomic<int> nextRequest(0);
+            std::atomic<int> daemonFound(0);
+            std::atomic<int> daemonErrors(0);
+            auto daemonStart = std::chrono::steady_clock::now();
+            std::vector<std::thread> clients;
+            for (int c = 0; c < numConnections; ++c) {
+                clients.emplace_back([&]() {
+                    try {
+                        LocalSocket connection = LocalSocket::connect(inputImagePath);
+                        std::string reply;
+                        while (nextRequest.fetch_add(1) < numRequests) {
+                            if (!connection.writeLine("EXTRACT\t" + benchImagePath) || !connection.readLine(reply)) {
+                                ++daemonErrors;
+                                return;
+                            }
+                            if (reply.compare(0, 2, "OK") == 0) {
+                                ++daemonFound;
+                            }
+                        }
+                    } catch (const std::exception& e) {
+                        ++daemonErrors;
+                    }
+                });
+            }
+            for (std::thread& client : clients) {
+                client.join();
+            }
+            double daemonSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - daemonStart).count();
+            if (daemonErrors > 0) {
+                std::cerr << "Error: " << daemonErrors << " daemon connection(s) failed; is the daemon running on " << inputImagePath << "?" << std::endl;
+                return -1;
+            }
+
+            // 2. ̣ͬ numConnections 
+            std::vector<std::string> command = workerArguments(argv[0]);
+            command.insert(command.end(), {"extract", benchImagePath, std::to_string(edgeThreshold)});
+            int processFailures = 0;
+            auto processStart = std::chrono::steady_clock::now();
+            for (int done = 0; done < numRequests; done += numConnections) {
+                std::vector<std::vector<std::string>> batch(std::min(numConnections, numRequests - done), command);
+                processFailures += VideoSharder::runParallel(batch, true);
+            }
+            double processSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - processStart).count();
+
+            double daemonRate = numRequests / daemonSeconds;
+            double processRate = numRequests / processSeconds;
+            std::cout << "Requests: " << numRequests << ", concurrency: " << numConnections << std::endl;
+            std::cout << "Daemon:      " << daemonRate << " req/s (" << daemonFound << " watermarks found)" << std::endl;
+            std::cout << "Per-process: " << processRate << " req/s (" << (numRequests - processFailures) << " watermarks found)" << std::endl;
+            std::cout << "Speedup:     " << daemonRate / processRate << "x" << std::endl;
+            return 0;
+        }
+
+        if (mode == "benchmark") {
+            std::string attackSpec = argc > 4 ? argv[4] : AttackSuite::defaultSpec();
+            int syntheticCount = 8;
+            if (argc > 5) {
+                try { syntheticCount = std::max(0, std::stoi(argv[5])); } catch (...) {}
+            }
+            std::vector<BenchmarkConfiguration> configurations(1);
+            configurations[0].profile = activeProfile;
+            if (argc > 3) {
+                configurations = BenchmarkConfiguration::parseList(argv[3], activeProfile);
+            }
+            std::vector<AttackChain> chains = AttackSuite::parseChains(attackSpec);
+
+            RobustnessBenchmark benchmark("temp_bench");
+            if (inputImagePath != "-") {
+                std::cout << "Loaded " << benchmark.addImagesFromDirectory(inputImagePath) << " images from " << inputImagePath << std::endl;
+            }
+            benchmark.addSyntheticImages(syntheticCount, cv::Size(512, 512));
+            if (benchmark.getImageCount() == 0) {
+                std::cerr << "Error: The benchmark corpus is empty." << std::endl;
+                return -1;
+            }
+            std::cout << "Running " << configurations.size() << " configuration(s) x " << chains.size() << " attack chain(s) on "
+                      << benchmark.getImageCount() << " images..." << std::endl;
+            setLibraryLogEnabled(false);
+            std::vector<BenchmarkRow> rows = benchmark.run(configurations, chains);
+            setLibraryLogEnabled(true);
+            RobustnessBenchmark::printReport(rows, std::cout);
+            if (argc > 6) {
+                RobustnessBenchmark::writeCsv(rows, argv[6]);
+                std::cout << "Report written to " << argv[6] << std::endl;
+            }
+            std::filesystem::remove_all("temp_bench");
+            return 0;
+        }
+
+        if (mode == "tune") {
+            if (argc < 4) {
+                printUsage(argv[0]);
+                return -1;
+            }
+            std::string profilePath = argv[3];
+            double targetSuccessRate = 0.95;
+            if (argc > 4) {
+                try { targetSuccessRate = std::stod(argv[4]); } catch (...) {}
+            }
+            std::string attackSpec = argc > 5 ? argv[5] : "jpeg:75,scale:0.75,noise:2";
+            int syntheticCount = 6;
+            if (argc > 6) {
+                try { syntheticCount = std::max(0, std::stoi(argv[6])); } catch (...) {}
+            }
+            std::vector<AttackChain> chains = AttackSuite::parseChains(attackSpec);
+
+            RobustnessBenchmark benchmark("temp_bench");
+            if (inputImagePath != "-") {
+                std::cout << "Loaded " << benchmark.addImagesFromDirectory(inputImagePath) << " images from " << inputImagePath << std::endl;
+            }
+            benchmark.addSyntheticImages(syntheticCount, cv::Size(512, 512));
+            if (benchmark.getImageCount() == 0) {
+                std::cerr << "Error: The tuning sample is empty." << std::endl;
+                return -1;
+            }
+            std::cout << "Tuning on " << benchmark.getImageCount() << " images for a success rate of at least "
+                      << targetSuccessRate * 100.0 << "% under: " << attackSpec << std::endl;
+
+            ParameterTuner tuner(benchmark, chains, targetSuccessRate);
+            tuner.setProgressStream(&std::cout);
+            setLibraryLogEnabled(false);
+            TuningCandidate best = tuner.tune(activeProfile);
+            setLibraryLogEnabled(true);
+            std::filesystem::remove_all("temp_bench");
+
+            std::ostringstream comment;
+            comment << "Tuned on " << benchmark.getImageCount() << " images, attacks: " << attackSpec << "\n"
+                    << "Target success rate " << targetSuccessRate << ", achieved " << best.successRate
+                    << ", " << best.processingMs << " ms/image (embed + extract)";
+            best.profile.save(profilePath, comment.str());
+            std::cout << "Evaluated " << tuner.getEvaluationCount() << " configurations." << std::endl;
+            std::cout << (best.meetsTarget ? "Fastest configuration meeting the target: " : "No configuration met the target; most robust: ")
+                      << best.profile.describe() << std::endl;
+            std::cout << "Profile written to " << profilePath << " (use with --profile)." << std::endl;
+            return best.meetsTarget ? 0 : 1;
+        }
+
+        if (mode == "screen") {
+            int scale = 4;
+            if (argc > 3) {
+                try {
+                    scale = std::stoi(argv[3]);
+                } catch (const std::exception& e) {
+                    std::cerr << "Warning: Invalid scale value. Using default: " << scale << std::endl;
+                }
+            }
+            if (argc > 4) {
+                try {
+                    edgeThreshold = std::stoi(argv[4]);
+                } catch (const std::exception& e) {
+                    std::cerr << "Warning: Invalid edge_threshold value. Using default: " << edgeThreshold << std::endl;
+                }
+            }
+
+            WatermarkPrescreener prescreener(profileWithEdgeThreshold(edgeThreshold), 361, scale);
+            PrescreenResult screenResult = prescreener.prescreen(inputImagePath);
+            const char* verdictNames[] = { "negative", "ambiguous", "positive" };
+            std::cout << "Pre-screen (1/" << scale << "): " << verdictNames[screenResult.verdict]
+                      << ", confidence " << screenResult.confidence
+                      << ", marker rate " << screenResult.markerRate * 100 << "%" << std::endl;
+            if (!screenResult.decodedText.empty()) {
+                std::cout << "Watermark decoded at reduced resolution:" << std::endl;
+                std::cout << screenResult.decodedText << std::endl;
+                return 0;
+            }
+            if (!screenResult.shouldEscalate()) {
+                return 1;
+            }
+
+            // ȷתȡ
+            std::cout << "Escalating to full extraction..." << std::endl;
+            cv::Mat fullImage = cv::imread(inputImagePath, cv::IMREAD_COLOR);
+            if (fullImage.empty()) {
+                std::cerr << "Error: Could not load image: " << inputImagePath << std::endl;
+                return -1;
+            }
+            cv::Mat yuvInput;
+            cv::cvtColor(fullImage, yuvInput, cv::COLOR_BGR2YCrCb);
+            std::vector<cv::Mat> yuvChannels;
+            cv::split(yuvInput, yuvChannels);
+
+            WatermarkExtractor extractor(361, profileWithEdgeThreshold(edgeThreshold));
+            std::string extractedText = extractor.extractWatermark(yuvChannels[0]);
+            if (!extractedText.empty()) {
+                std::cout << "Watermark extracted successfully:" << std::endl;
+                std::cout << extractedText << std::endl;
+                return 0;
+            }
+            std::cout << "Watermark extraction failed or resulted in empty text." << std::endl;
+            return 1;
+        }
+
+        // ͼ (ɫextract --gray ʱΪͨ)
+        cv::Mat inputImage = cv::imread(inputImagePath, grayDecode ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
         if (inputImage.empty()) {
             std::cerr << "Error: Could not load image: " << inputImagePath << std::endl;
             return -1;
@@ -220,7 +1032,7 @@ int main(int argc, char** argv) {
 
             // Ƕʵ
             //  numRegions Ϊ 0WatermarkEmbedder ڲˮӡȷ
-            WatermarkEmbedder embedder(numRegions == 0 ? 4 : numRegions, edgeThreshold); // ṩһĬֵԷһ
+            WatermarkEmbedder embedder(profileWithEdgeThreshold(edgeThreshold), numRegions == 0 ? 4 : numRegions); // ṩһĬֵԷһ
 
             // ִˮӡǶ루Yͨϣ
             std::cout << "Embedding watermark..." << std::endl;
@@ -238,7 +1050,71 @@ int main(int argc, char** argv) {
             } else {
                 std::cerr << "Error: Could not save watermarked image to: " << outputImagePath << std::endl;
                 return -1;
-            }        } else if (mode == "extract") {
+            }        } else if (mode == "embed-batch") {
+            if (argc < 5) {
+                std::cerr << "Error: Missing arguments for embed-batch mode." << std::endl;
+                printUsage(argv[0]);
+                return -1;
+            }
+            std::string outputDir = argv[3];
+            std::string recipientsPath = argv[4];
+            if (argc > 5) {
+                try {
+                    edgeThreshold = std::stoi(argv[5]);
+                } catch (const std::exception& e) {
+                    std::cerr << "Warning: Invalid edge_threshold value. Using default: " << edgeThreshold << std::endl;
+                }
+            }
+
+            std::ifstream recipients(recipientsPath);
+            if (!recipients) {
+                std::cerr << "Error: Could not open recipients file: " << recipientsPath << std::endl;
+                return -1;
+            }
+            std::filesystem::create_directories(outputDir);
+
+            cv::Mat yuvInput;
+            cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
+            std::vector<cv::Mat> yuvChannels;
+            cv::split(yuvInput, yuvChannels);
+
+            // ͼֻһβԤÿ 0/1 壬ÿշֻͰλ
+            WatermarkEmbedder embedder(profileWithEdgeThreshold(edgeThreshold));
+            EmbeddingAnalysis analysis = embedder.analyze(yuvChannels[0]);
+            BlockVariantBank variantBank;
+            embedder.buildVariantBank(analysis, variantBank);
+            std::cout << "Block variant bank built (" << variantBank.getMemoryBytes() << " bytes)." << std::endl;
+
+            std::string watermarkText;
+            int lineNumber = 0;
+            int embeddedCount = 0;
+            cv::Mat watermarkedYUV, watermarkedBGR;
+            while (std::getline(recipients, watermarkText)) {
+                ++lineNumber;
+                if (!watermarkText.empty() && watermarkText.back() == '\r') {
+                    watermarkText.pop_back();
+                }
+                if (watermarkText.empty()) {
+                    continue;
+                }
+                if (watermarkText.length() > 8) {
+                    watermarkText = watermarkText.substr(0, 8);
+                    std::cout << "Watermark text truncated to 8 characters: " << watermarkText << std::endl;
+                }
+
+                embedder.embed(variantBank, watermarkText, yuvChannels[0]);
+                cv::merge(yuvChannels, watermarkedYUV);
+                cv::cvtColor(watermarkedYUV, watermarkedBGR, cv::COLOR_YCrCb2BGR);
+
+                std::string outputImagePath = (std::filesystem::path(outputDir) / (std::to_string(lineNumber) + ".png")).string();
+                if (!cv::imwrite(outputImagePath, watermarkedBGR)) {
+                    std::cerr << "Error: Could not save watermarked image to: " << outputImagePath << std::endl;
+                    return -1;
+                }
+                ++embeddedCount;
+            }
+            std::cout << "Embedded " << embeddedCount << " watermarks into " << outputDir << std::endl;
+        } else if (mode == "extract") {
             // ̶ˮӡΪ361λҪд
             int expectedLength = 361;
 
@@ -251,19 +1127,107 @@ int main(int argc, char** argv) {
                 }
             }
 
-            // ȡʱҲYͨ
+            // ȡʱҲYͨ (--gray ʱ)
+            cv::Mat lumaInput;
+            if (grayDecode) {
+                lumaInput = inputImage;
+            } else {
+                cv::Mat yuvInput;
+                cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
+                std::vector<cv::Mat> yuvChannels;
+                cv::split(yuvInput, yuvChannels);
+                lumaInput = yuvChannels[0];
+            }
+
+            // ȡʵҪԭʼͼ·
+            WatermarkExtractor extractor(expectedLength, profileWithEdgeThreshold(edgeThreshold));
+            if (argc > 4) {
+                extractor.setAnalysisCache(argv[4]);
+            }
+
+            // ִˮӡȡ
+            std::cout << "Extracting watermark..." << std::endl;
+            std::string extractedText = extractor.extractWatermark(lumaInput);
+
+            if (!extractedText.empty()) {
+                std::cout << "Watermark extracted successfully:" << std::endl;
+                std::cout << extractedText << std::endl;
+            } else {
+                std::cout << "Watermark extraction failed or resulted in empty text." << std::endl;
+                return 1;
+            }
+
+        } else if (mode == "extract-multi") {
+            std::vector<double> imageScales;
+            if (argc > 3) {
+                std::stringstream scaleList(argv[3]);
+                std::string item;
+                while (std::getline(scaleList, item, ',')) {
+                    try {
+                        imageScales.push_back(std::stod(item));
+                    } catch (const std::exception& e) {
+                        std::cerr << "Warning: Invalid scale value '" << item << "' ignored." << std::endl;
+                    }
+                }
+            }
+            if (imageScales.empty()) {
+                imageScales.push_back(1.0);
+            }
+
             cv::Mat yuvInput;
             cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
             std::vector<cv::Mat> yuvChannels;
             cv::split(yuvInput, yuvChannels);
 
-            // ȡʵҪԭʼͼ·
-            WatermarkExtractor extractor(expectedLength, edgeThreshold);
+            // Ĭϲ (ļеֵ) ǰȵȣȡļ
+            std::vector<int> edgeThresholds{ edgeThreshold };
+            for (int value : { 3, 10, 25 }) {
+                if (value != edgeThreshold) edgeThresholds.push_back(value);
+            }
+            std::vector<double> windowScales{ activeProfile.windowScale };
+            for (double value : { 0.25, 0.2, 0.3 }) {
+                if (value != activeProfile.windowScale) windowScales.push_back(value);
+            }
+            MultiHypothesisExtractor multiExtractor(361, activeProfile);
+            multiExtractor.addGrid(edgeThresholds, windowScales, { activeProfile.stepScale }, imageScales);
+            std::cout << "Trying " << multiExtractor.getHypotheses().size() << " extraction hypotheses..." << std::endl;
+            HypothesisResult multiResult = multiExtractor.extract(yuvChannels[0]);
+            if (!multiResult.found) {
+                std::cout << "No hypothesis produced a valid watermark." << std::endl;
+                return 1;
+            }
+            std::cout << "Watermark extracted successfully (edge_threshold " << multiResult.hypothesis.edgeThreshold
+                      << ", window " << multiResult.hypothesis.windowScale
+                      << ", step " << multiResult.hypothesis.stepScale
+                      << ", scale " << multiResult.hypothesis.imageScale << "):" << std::endl;
+            std::cout << multiResult.text << std::endl;
 
-            // ִˮӡȡ
-            std::cout << "Extracting watermark..." << std::endl;
-            std::string extractedText = extractor.extractWatermark(yuvChannels[0]);
+        } else if (mode == "extract-resync") {
+            int searchRadius = 16;
+            if (argc > 3) {
+                try {
+                    edgeThreshold = std::stoi(argv[3]);
+                } catch (const std::exception& e) {
+                    std::cerr << "Warning: Invalid edge_threshold value. Using default: " << edgeThreshold << std::endl;
+                }
+            }
+            if (argc > 4) {
+                try {
+                    searchRadius = std::stoi(argv[4]);
+                } catch (const std::exception& e) {
+                    std::cerr << "Warning: Invalid search_radius value. Using default: " << searchRadius << std::endl;
+                }
+            }
 
+            cv::Mat yuvInput;
+            cv::cvtColor(inputImage, yuvInput, cv::COLOR_BGR2YCrCb);
+            std::vector<cv::Mat> yuvChannels;
+            cv::split(yuvInput, yuvChannels);
+
+            WatermarkExtractor extractor(361, profileWithEdgeThreshold(edgeThreshold));
+            extractor.setGridResync(searchRadius);
+            std::cout << "Extracting watermark with block grid resynchronization..." << std::endl;
+            std::string extractedText = extractor.extractWatermark(yuvChannels[0]);
             if (!extractedText.empty()) {
                 std::cout << "Watermark extracted successfully:" << std::endl;
                 std::cout << extractedText << std::endl;
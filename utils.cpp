@@ -1,5 +1,6 @@
 #include "utils.h"
-#include <map>
+#include <atomic>
+#include <iostream>
 #include <numeric>
 
 // DCTʹOpenCV
@@ -25,18 +26,20 @@ cv::Mat calculateIDCT(const cv::Mat& input) {
 
 // Ϣ (ʽ 3 ĺĲ)
 double calculateEntropy(const cv::Mat& region) {
-    std::map<uchar, int> hist;
+    int hist[256] = { 0 }; // ̶Сֱͼص map ڵ
     int totalPixels = region.rows * region.cols;
     if (totalPixels == 0) return 0.0;
 
     for (int i = 0; i < region.rows; ++i) {
+        const uchar* row = region.ptr<uchar>(i);
         for (int j = 0; j < region.cols; ++j) {
-            hist[region.at<uchar>(i, j)]++;
+            hist[row[j]]++;
         }
     }
 
     double entropy = 0.0;
-    for (auto const& [pixelValue, count] : hist) {
+    for (int pixelValue = 0; pixelValue < 256; ++pixelValue) {
+        int count = hist[pixelValue];
         if (count > 0) {
             double probability = static_cast<double>(count) / totalPixels;
             entropy -= probability * std::log2(probability); // ʹ log base 2
@@ -69,3 +72,41 @@ cv::Mat calculateGaussianWeights(int rows, int cols, double sigma) {
     }
     return weights;
 }
+
+static std::atomic<bool> libraryLogEnabled(true);
+static thread_local int libraryLogMuteDepth = 0; // ǰ߳ ScopedLibraryLogMute Ƕײ
+
+// ǰ̵߳Ŀ޻дֱʧܡʽ (ʧ״ֻ̬ڱ߳ۻ)
+static std::ostream& discardStream() {
+    thread_local std::ostream stream(nullptr);
+    return stream;
+}
+
+bool isLibraryLogEnabled() {
+    return libraryLogMuteDepth == 0 && libraryLogEnabled.load(std::memory_order_relaxed);
+}
+
+std::ostream& libraryLog() {
+    return isLibraryLogEnabled() ? std::cout : discardStream();
+}
+
+std::ostream& libraryWarning() {
+    return isLibraryLogEnabled() ? std::cerr : discardStream();
+}
+
+void setLibraryLogEnabled(bool enabled) {
+    libraryLogEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+ScopedLibraryLogMute::ScopedLibraryLogMute(bool active)
+    : active(active) {
+    if (active) {
+        ++libraryLogMuteDepth;
+    }
+}
+
+ScopedLibraryLogMute::~ScopedLibraryLogMute() {
+    if (active) {
+        --libraryLogMuteDepth;
+    }
+}
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <cmath>
+#include <ostream>
 #include <opencv2/opencv.hpp>
 
 // ṹ
@@ -30,6 +31,7 @@ struct ImageBlock {
     int fixedEdgePixelCount = 0; // N*_xy
     double embeddingStrength = 0.0; // sigma_xy
     double totalModification = 0.0; // g(sigma_xy, w_xy)
+    double dcCoefficient = 0.0; // R_DCxyԭʼ DC ϵ (ֿʱ㣬Ƕʱ)
     cv::Mat modificationWeights; // theta_xy(i,j) for edge blocks
 };
 
@@ -48,5 +50,26 @@ double calculateEntropy(const cv::Mat& region);
 // ˹Ȩ
 cv::Mat calculateGaussianWeights(int rows, int cols, double sigma);
 
+// ڲĽ־ (Ĭ std::cout) 뾯 (Ĭ std::cerr)
+// رպ߶setLibraryLogEnabled ǽ̼ (ֻ CLI ʹ)
+// ScopedLibraryLogMute ֻرյǰ߳ (Ĺ̡߳C API ʹãӰ߳)
+// ʱصǰ߳ԼĿ̲ͬ߳״̬ʽ۸ߵ־ isLibraryLogEnabled() ж
+std::ostream& libraryLog();
+std::ostream& libraryWarning();
+void setLibraryLogEnabled(bool enabled);
+bool isLibraryLogEnabled();
+
+// ڹرյǰ̵߳Ŀ־ (Ƕ)active Ϊ false ʱκ
+class ScopedLibraryLogMute {
+public:
+    explicit ScopedLibraryLogMute(bool active = true);
+    ~ScopedLibraryLogMute();
+    ScopedLibraryLogMute(const ScopedLibraryLogMute&) = delete;
+    ScopedLibraryLogMute& operator=(const ScopedLibraryLogMute&) = delete;
+
+private:
+    bool active;
+};
+
 
 #endif // UTILS_H